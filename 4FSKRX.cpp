@@ -0,0 +1,411 @@
+/*
+ *   Generic 4FSK receiver parts shared by the DMR, YSF, P25 and NXDN receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "4FSKRX.h"
+
+const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+
+template <class TRAITS>
+C4FSKRX<TRAITS>::C4FSKRX() :
+m_bitBuffer(),
+m_buffer(),
+m_correlator(),
+m_bitPtr(0U),
+m_dataPtr(0U),
+m_centre(),
+m_centreVal(0),
+m_threshold(),
+m_thresholdVal(0),
+m_averagePtr(NOAVEPTR),
+m_rssiAccum(0U),
+m_rssiCount(0U)
+{
+  m_correlator.setSync(TRAITS::SYNC_SYMBOLS_VALUES, TRAITS::SYNC_LENGTH_SYMBOLS, TRAITS::SYMBOL_LENGTH);
+}
+
+template <class TRAITS>
+void C4FSKRX<TRAITS>::resetRX()
+{
+  m_dataPtr      = 0U;
+  m_bitPtr       = 0U;
+  m_averagePtr   = NOAVEPTR;
+  m_centreVal    = 0;
+  m_thresholdVal = 0;
+  m_rssiAccum    = 0U;
+  m_rssiCount    = 0U;
+}
+
+template <class TRAITS>
+void C4FSKRX<TRAITS>::syncLevels(q15_t min, q15_t max, q15_t& centre, q15_t& threshold) const
+{
+  centre = (max + min) >> 1;
+
+  q31_t v1 = (max - centre) * TRAITS::SCALING_FACTOR;
+  threshold = q15_t(v1 >> 15);
+}
+
+template <class TRAITS>
+uint64_t C4FSKRX<TRAITS>::syncToBits(uint16_t start, q15_t centre, q15_t threshold) const
+{
+  uint64_t bits = 0U;
+
+  for (uint16_t i = 0U; i < TRAITS::SYNC_LENGTH_SYMBOLS; i++) {
+    q15_t sample = m_buffer[start] - centre;
+
+    if (sample < -threshold)
+      bits = (bits << 2) | 0x01U;
+    else if (sample < 0)
+      bits = (bits << 2) | 0x00U;
+    else if (sample < threshold)
+      bits = (bits << 2) | 0x02U;
+    else
+      bits = (bits << 2) | 0x03U;
+
+    start += TRAITS::SYMBOL_LENGTH;
+    if (start >= TRAITS::BUFFER_LENGTH)
+      start -= TRAITS::BUFFER_LENGTH;
+  }
+
+  return bits;
+}
+
+template <class TRAITS>
+void C4FSKRX<TRAITS>::calculateLevels(uint16_t start, uint16_t count)
+{
+  q15_t maxPos = -16000;
+  q15_t minPos =  16000;
+  q15_t maxNeg =  16000;
+  q15_t minNeg = -16000;
+
+  for (uint16_t i = 0U; i < count; i++) {
+    q15_t sample = m_buffer[start];
+
+    if (sample > 0) {
+      if (sample > maxPos)
+        maxPos = sample;
+      if (sample < minPos)
+        minPos = sample;
+    } else {
+      if (sample < maxNeg)
+        maxNeg = sample;
+      if (sample > minNeg)
+        minNeg = sample;
+    }
+
+    start += TRAITS::SYMBOL_LENGTH;
+    if (start >= TRAITS::BUFFER_LENGTH)
+      start -= TRAITS::BUFFER_LENGTH;
+  }
+
+  q15_t posThresh = (maxPos + minPos) >> 1;
+  q15_t negThresh = (maxNeg + minNeg) >> 1;
+
+  q15_t centre = (posThresh + negThresh) >> 1;
+
+  q15_t threshold = posThresh - centre;
+
+  DEBUG6("%s: pos/neg/centre/threshold", TRAITS::NAME, posThresh, negThresh, centre, threshold);
+
+  averageLevels(centre, threshold);
+}
+
+template <class TRAITS>
+void C4FSKRX<TRAITS>::averageLevels(q15_t centre, q15_t threshold)
+{
+  if (m_averagePtr == NOAVEPTR) {
+    for (uint8_t i = 0U; i < AVERAGE_LENGTH; i++) {
+      m_centre[i]    = centre;
+      m_threshold[i] = threshold;
+    }
+
+    m_averagePtr = 0U;
+  } else {
+    m_centre[m_averagePtr]    = centre;
+    m_threshold[m_averagePtr] = threshold;
+
+    m_averagePtr++;
+    if (m_averagePtr >= AVERAGE_LENGTH)
+      m_averagePtr = 0U;
+  }
+
+  // Summed in 32 bits, sixteen q15 levels overflow a q15 sum well inside the input range
+  q31_t centreSum    = 0;
+  q31_t thresholdSum = 0;
+
+  for (uint8_t i = 0U; i < AVERAGE_LENGTH; i++) {
+    centreSum    += m_centre[i];
+    thresholdSum += m_threshold[i];
+  }
+
+  m_centreVal    = q15_t(centreSum    >> TRAITS::AVERAGE_SHIFT);
+  m_thresholdVal = q15_t(thresholdSum >> TRAITS::AVERAGE_SHIFT);
+}
+
+template <class TRAITS>
+void C4FSKRX<TRAITS>::samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold) const
+{
+  for (uint16_t i = 0U; i < count; i++) {
+    q15_t sample = m_buffer[start] - centre;
+
+    if (sample < -threshold) {
+      WRITE_BIT1(buffer, offset, false);
+      offset++;
+      WRITE_BIT1(buffer, offset, true);
+      offset++;
+    } else if (sample < 0) {
+      WRITE_BIT1(buffer, offset, false);
+      offset++;
+      WRITE_BIT1(buffer, offset, false);
+      offset++;
+    } else if (sample < threshold) {
+      WRITE_BIT1(buffer, offset, true);
+      offset++;
+      WRITE_BIT1(buffer, offset, false);
+      offset++;
+    } else {
+      WRITE_BIT1(buffer, offset, true);
+      offset++;
+      WRITE_BIT1(buffer, offset, true);
+      offset++;
+    }
+
+    start += TRAITS::SYMBOL_LENGTH;
+    if (start >= TRAITS::BUFFER_LENGTH)
+      start -= TRAITS::BUFFER_LENGTH;
+  }
+}
+
+template <class TRAITS>
+C4FSKFrameRX<TRAITS>::C4FSKFrameRX() :
+RX(),
+m_state(STATE_NONE),
+m_startPtr(RX::NOENDPTR),
+m_endPtr(RX::NOENDPTR),
+m_syncPtr(RX::NOENDPTR),
+m_minSyncPtr(RX::NOENDPTR),
+m_maxSyncPtr(RX::NOENDPTR),
+m_maxCorr(0),
+m_lostCount(0U),
+m_countdown(0U)
+{
+}
+
+template <class TRAITS>
+void C4FSKFrameRX<TRAITS>::reset()
+{
+  RX::resetRX();
+
+  m_state      = STATE_NONE;
+  m_maxCorr    = 0;
+  m_startPtr   = RX::NOENDPTR;
+  m_endPtr     = RX::NOENDPTR;
+  m_syncPtr    = RX::NOENDPTR;
+  m_minSyncPtr = RX::NOENDPTR;
+  m_maxSyncPtr = RX::NOENDPTR;
+  m_lostCount  = 0U;
+  m_countdown  = 0U;
+}
+
+template <class TRAITS>
+void C4FSKFrameRX<TRAITS>::samples(const q15_t* samples, const uint16_t* rssi, uint16_t length)
+{
+  for (uint16_t i = 0U; i < length; i++) {
+    RX::accumulateRSSI(rssi[i]);
+    RX::write(samples[i]);
+
+    switch (m_state) {
+    case STATE_DATA:
+      processData();
+      break;
+    default:
+      processNone();
+      break;
+    }
+
+    RX::next();
+  }
+}
+
+template <class TRAITS>
+void C4FSKFrameRX<TRAITS>::processNone()
+{
+  bool ret = correlateSync();
+  if (ret) {
+    // On the first sync, start the countdown to the state change
+    if (m_countdown == 0U) {
+      RX::m_rssiAccum = 0U;
+      RX::m_rssiCount = 0U;
+
+      io.setDecode(true);
+      io.setADCDetection(true);
+
+      RX::m_averagePtr = RX::NOAVEPTR;
+
+      m_countdown = 2U;
+    }
+  }
+
+  if (m_countdown > 0U)
+    m_countdown--;
+
+  if (m_countdown == 1U) {
+    m_minSyncPtr = m_syncPtr + TRAITS::BUFFER_LENGTH - 1U;
+    if (m_minSyncPtr >= TRAITS::BUFFER_LENGTH)
+      m_minSyncPtr -= TRAITS::BUFFER_LENGTH;
+
+    m_maxSyncPtr = m_syncPtr + 1U;
+    if (m_maxSyncPtr >= TRAITS::BUFFER_LENGTH)
+      m_maxSyncPtr -= TRAITS::BUFFER_LENGTH;
+
+    m_state      = STATE_DATA;
+    m_countdown  = 0U;
+  }
+}
+
+template <class TRAITS>
+void C4FSKFrameRX<TRAITS>::processData()
+{
+  uint16_t dataPtr = RX::m_dataPtr;
+
+  if (m_minSyncPtr < m_maxSyncPtr) {
+    if (dataPtr >= m_minSyncPtr && dataPtr <= m_maxSyncPtr)
+      correlateSync();
+  } else {
+    if (dataPtr >= m_minSyncPtr || dataPtr <= m_maxSyncPtr)
+      correlateSync();
+  }
+
+  if (dataPtr == m_endPtr) {
+    // Only update the centre and threshold if they are from a good sync
+    if (m_lostCount == TRAITS::MAX_SYNC_FRAMES) {
+      m_minSyncPtr = m_syncPtr + TRAITS::BUFFER_LENGTH - 1U;
+      if (m_minSyncPtr >= TRAITS::BUFFER_LENGTH)
+        m_minSyncPtr -= TRAITS::BUFFER_LENGTH;
+
+      m_maxSyncPtr = m_syncPtr + 1U;
+      if (m_maxSyncPtr >= TRAITS::BUFFER_LENGTH)
+        m_maxSyncPtr -= TRAITS::BUFFER_LENGTH;
+    }
+
+    RX::calculateLevels(m_startPtr, TRAITS::BUFFER_LENGTH);
+
+    DEBUG5("%s: sync found pos/centre/threshold", TRAITS::NAME, m_syncPtr, RX::m_centreVal, RX::m_thresholdVal);
+
+    uint8_t frame[TRAITS::FRAME_LENGTH_BYTES + 3U];
+    RX::samplesToBits(m_startPtr, TRAITS::BUFFER_LENGTH, frame, 8U, RX::m_centreVal, RX::m_thresholdVal);
+
+    // We've not seen a data sync for too long, signal RXLOST and change to RX_NONE
+    m_lostCount--;
+    if (m_lostCount == 0U) {
+      DEBUG2("%s: sync timed out, lost lock", TRAITS::NAME);
+
+      io.setDecode(false);
+      io.setADCDetection(false);
+
+      TRAITS::writeLost();
+
+      m_state          = STATE_NONE;
+      m_endPtr         = RX::NOENDPTR;
+      RX::m_averagePtr = RX::NOAVEPTR;
+      m_countdown      = 0U;
+      m_maxCorr        = 0;
+    } else {
+      frame[0U] = m_lostCount == (TRAITS::MAX_SYNC_FRAMES - 1U) ? 0x01U : 0x00U;
+      writeRSSIData(frame);
+      m_maxCorr = 0;
+    }
+  }
+}
+
+template <class TRAITS>
+bool C4FSKFrameRX<TRAITS>::correlateSync()
+{
+  if (RX::countSyncSymbolErrs() <= TRAITS::MAX_SYNC_SYMBOLS_ERRS) {
+    q15_t min, max;
+    q31_t corr = RX::correlate(min, max);
+
+    if (corr > m_maxCorr) {
+      if (RX::m_averagePtr == RX::NOAVEPTR)
+        RX::syncLevels(min, max, RX::m_centreVal, RX::m_thresholdVal);
+
+      uint16_t startPtr = RX::syncStartPtr();
+
+      uint8_t maxErrs;
+      if (m_state == STATE_NONE)
+        maxErrs = TRAITS::MAX_SYNC_BIT_START_ERRS;
+      else
+        maxErrs = TRAITS::MAX_SYNC_BIT_RUN_ERRS;
+
+      uint64_t bits = RX::syncToBits(startPtr, RX::m_centreVal, RX::m_thresholdVal);
+      uint8_t errs  = countSyncErrs(bits, TRAITS::SYNC_BITS, TRAITS::SYNC_BITS_MASK);
+
+      if (errs <= maxErrs) {
+        m_maxCorr   = corr;
+        m_lostCount = TRAITS::MAX_SYNC_FRAMES;
+        m_syncPtr   = RX::m_dataPtr;
+
+        m_startPtr = startPtr;
+
+        m_endPtr = RX::m_dataPtr + TRAITS::BUFFER_LENGTH - TRAITS::SYNC_LENGTH_SYMBOLS - 1U;
+        if (m_endPtr >= TRAITS::BUFFER_LENGTH)
+          m_endPtr -= TRAITS::BUFFER_LENGTH;
+
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+template <class TRAITS>
+void C4FSKFrameRX<TRAITS>::writeRSSIData(uint8_t* data)
+{
+#if defined(SEND_RSSI_DATA)
+  if (RX::m_rssiCount > 0U) {
+    uint16_t rssi = RX::m_rssiAccum / RX::m_rssiCount;
+
+    data[TRAITS::FRAME_LENGTH_BYTES + 1U] = (rssi >> 8) & 0xFFU;
+    data[TRAITS::FRAME_LENGTH_BYTES + 2U] = (rssi >> 0) & 0xFFU;
+
+    TRAITS::writeData(data, TRAITS::FRAME_LENGTH_BYTES + 3U);
+  } else {
+    TRAITS::writeData(data, TRAITS::FRAME_LENGTH_BYTES + 1U);
+  }
+#else
+  TRAITS::writeData(data, TRAITS::FRAME_LENGTH_BYTES + 1U);
+#endif
+
+  RX::m_rssiAccum = 0U;
+  RX::m_rssiCount = 0U;
+}
+
+// The receivers built on these templates, the traits of each are in its own header
+template class C4FSKRX<DMRIDLERX_TRAITS>;
+template class C4FSKRX<DMRSLOTRX_TRAITS>;
+template class C4FSKRX<DMRDMORX_TRAITS>;
+template class C4FSKRX<YSFRX_TRAITS>;
+template class C4FSKRX<P25RX_TRAITS>;
+template class C4FSKRX<NXDNRX_TRAITS>;
+
+template class C4FSKFrameRX<YSFRX_TRAITS>;
+template class C4FSKFrameRX<NXDNRX_TRAITS>;
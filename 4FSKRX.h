@@ -0,0 +1,178 @@
+/*
+ *   Generic 4FSK receiver parts shared by the DMR, YSF, P25 and NXDN receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(C4FSKRX_H)
+#define  C4FSKRX_H
+
+#include "Config.h"
+#include "SyncCorrelator.h"
+#include "Utils.h"
+
+/*
+ * The buffering, sync correlation, level tracking and bit slicing common to the 4FSK receivers,
+ * written once and specialised at compile time by a traits class per receiver. TRAITS gives:
+ *
+ *   NAME                   prefix of the debug messages
+ *   BUFFER_LENGTH          values held in the circular buffer
+ *   SYMBOL_LENGTH          values per symbol, one for a symbol stream
+ *   SYNC_SYMBOLS_VALUES    the sync as +3, +1, -1 and -3 symbol values
+ *   SYNC_LENGTH_SYMBOLS    symbols in the sync, at most 32
+ *   SYNC_SYMBOLS           the sync as one sign bit per symbol, and its mask
+ *   SYNC_SYMBOLS_MASK
+ *   MAX_SYNC_SYMBOLS_ERRS  sign errors allowed before the sync is correlated
+ *   SYNC_BITS              the sync as two bits per symbol, and its mask
+ *   SYNC_BITS_MASK
+ *   SCALING_FACTOR         threshold from the sync peak, q15
+ *   AVERAGE_SHIFT          log2 of the number of levels averaged
+ */
+template <class TRAITS>
+class C4FSKRX {
+protected:
+  C4FSKRX();
+
+  void resetRX();
+
+  // Stores the newest value at m_dataPtr, next() then moves on to the following one
+  void write(q15_t sample)
+  {
+    m_buffer[m_dataPtr] = sample;
+    m_correlator.write(sample);
+
+    m_bitBuffer[m_bitPtr] <<= 1;
+    if (sample < 0)
+      m_bitBuffer[m_bitPtr] |= 0x01U;
+  }
+
+  void next()
+  {
+    m_dataPtr++;
+    if (m_dataPtr >= TRAITS::BUFFER_LENGTH)
+      m_dataPtr = 0U;
+
+    m_bitPtr++;
+    if (m_bitPtr >= TRAITS::SYMBOL_LENGTH)
+      m_bitPtr = 0U;
+  }
+
+  void accumulateRSSI(uint16_t rssi)
+  {
+    m_rssiAccum += rssi;
+    m_rssiCount++;
+  }
+
+  // Sign errors between the last sync length symbols and the sync
+  uint8_t countSyncSymbolErrs() const
+  {
+    return countBits32((m_bitBuffer[m_bitPtr] & TRAITS::SYNC_SYMBOLS_MASK) ^ TRAITS::SYNC_SYMBOLS);
+  }
+
+  // Correlation of the sync ending at the newest value, with the extremes of its symbols
+  q31_t correlate(q15_t& min, q15_t& max) const
+  {
+    return m_correlator.correlate(min, max);
+  }
+
+  // Position of the first symbol of a sync ending at the newest value
+  uint16_t syncStartPtr() const
+  {
+    uint16_t ptr = m_dataPtr + TRAITS::BUFFER_LENGTH - TRAITS::SYNC_LENGTH_SYMBOLS * TRAITS::SYMBOL_LENGTH + TRAITS::SYMBOL_LENGTH;
+    if (ptr >= TRAITS::BUFFER_LENGTH)
+      ptr -= TRAITS::BUFFER_LENGTH;
+
+    return ptr;
+  }
+
+  // Centre and threshold taken from the extremes of a sync
+  void syncLevels(q15_t min, q15_t max, q15_t& centre, q15_t& threshold) const;
+
+  // Slices the sync starting at start into two bits per symbol, to match against SYNC_BITS
+  uint64_t syncToBits(uint16_t start, q15_t centre, q15_t threshold) const;
+
+  // Takes the centre and threshold of count symbols from start into the running average
+  void calculateLevels(uint16_t start, uint16_t count);
+
+  // Adds a centre and threshold to the running average in m_centreVal and m_thresholdVal. The
+  // first after m_averagePtr is set to NOAVEPTR fills the whole average.
+  void averageLevels(q15_t centre, q15_t threshold);
+
+  void samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold) const;
+
+  static constexpr uint8_t  NOAVEPTR       = 99U;
+  static constexpr uint16_t NOENDPTR       = 9999U;
+  static constexpr uint8_t  AVERAGE_LENGTH = 1U << TRAITS::AVERAGE_SHIFT;
+
+  uint32_t        m_bitBuffer[TRAITS::SYMBOL_LENGTH];
+  q15_t           m_buffer[TRAITS::BUFFER_LENGTH];
+  CSyncCorrelator m_correlator;
+  uint16_t        m_bitPtr;
+  uint16_t        m_dataPtr;
+  q15_t           m_centre[AVERAGE_LENGTH];
+  q15_t           m_centreVal;
+  q15_t           m_threshold[AVERAGE_LENGTH];
+  q15_t           m_thresholdVal;
+  uint8_t         m_averagePtr;
+  uint32_t        m_rssiAccum;
+  uint16_t        m_rssiCount;
+};
+
+/*
+ * A complete receiver for the protocols with a single frame type that starts with its sync, YSF
+ * and NXDN. Beyond the C4FSKRX traits, TRAITS gives:
+ *
+ *   FRAME_LENGTH_BYTES       bytes in a frame, BUFFER_LENGTH is the frame in symbols
+ *   MAX_SYNC_BIT_START_ERRS  bit errors allowed in the first sync
+ *   MAX_SYNC_BIT_RUN_ERRS    and in the later ones
+ *   MAX_SYNC_FRAMES          frames without a sync before the lock is lost, plus one
+ *   writeData(data, length)  hands a frame to the host
+ *   writeLost()              tells the host the lock was lost
+ */
+template <class TRAITS>
+class C4FSKFrameRX : public C4FSKRX<TRAITS> {
+public:
+  C4FSKFrameRX();
+
+  // Takes one value per symbol, at the symbol centre found by CSymbolTiming
+  void samples(const q15_t* samples, const uint16_t* rssi, uint16_t length);
+
+  void reset();
+
+private:
+  typedef C4FSKRX<TRAITS> RX;
+
+  enum STATE {
+    STATE_NONE,
+    STATE_DATA
+  };
+
+  STATE    m_state;
+  uint16_t m_startPtr;
+  uint16_t m_endPtr;
+  uint16_t m_syncPtr;
+  uint16_t m_minSyncPtr;
+  uint16_t m_maxSyncPtr;
+  q31_t    m_maxCorr;
+  uint16_t m_lostCount;
+  uint8_t  m_countdown;
+
+  void processNone();
+  void processData();
+  bool correlateSync();
+  void writeRSSIData(uint8_t* data);
+};
+
+#endif
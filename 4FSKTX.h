@@ -0,0 +1,155 @@
+/*
+ *   Table driven 4FSK modulator shared by the DMR, YSF, P25 and NXDN transmitters
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(C4FSKTX_H)
+#define  C4FSKTX_H
+
+#include "Config.h"
+#include "Globals.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * The interpolating pulse shaping filter of the 4FSK transmitters sees only four input levels,
+ * so each output sample is a sum of at most nine terms chosen by the last nine symbols. Those
+ * terms are tabled in groups of three symbols, 64 entries per group and phase, and a symbol
+ * costs three table reads and two adds per output sample instead of a filter pass. The sums are
+ * the exact integer sums arm_fir_interpolate_q15 forms, so the output matches it bit for bit.
+ */
+const uint16_t TX_4FSK_GROUP_SYMBOLS = 3U;
+const uint16_t TX_4FSK_GROUPS        = 3U;
+const uint16_t TX_4FSK_GROUP_ENTRIES = 1U << (2U * TX_4FSK_GROUP_SYMBOLS);
+
+// Bytes modulated per io.write by the transmitters
+const uint16_t TX_4FSK_BLOCK_BYTES = 16U;
+
+// The table for taps laid out for arm_fir_interpolate_q15 at SPS samples per symbol, with a to d
+// the levels of the +3, +1, -1 and -3 symbols
+template <uint16_t SPS, size_t N>
+constexpr std::array<q31_t, TX_4FSK_GROUPS * TX_4FSK_GROUP_ENTRIES * SPS> modTable(const std::array<int16_t, N>& taps, q15_t a, q15_t b, q15_t c, q15_t d)
+{
+  static_assert((N % SPS) == 0U && (N / SPS) <= (TX_4FSK_GROUPS * TX_4FSK_GROUP_SYMBOLS), "the filter must be whole phases of at most nine symbols");
+
+  const size_t phaseLen = N / SPS;
+
+  // By dibit, 00 is -1, 01 is -3, 10 is +1 and 11 is +3
+  const q31_t level[4U] = {c, d, b, a};
+
+  std::array<q31_t, TX_4FSK_GROUPS * TX_4FSK_GROUP_ENTRIES * SPS> table{};
+
+  for (size_t group = 0U; group < TX_4FSK_GROUPS; group++) {
+    for (size_t entry = 0U; entry < TX_4FSK_GROUP_ENTRIES; entry++) {
+      for (size_t phase = 0U; phase < SPS; phase++) {
+        q31_t sum = 0;
+
+        // Symbol s of an entry is the one s + 3 * group symbols before the newest
+        for (size_t s = 0U; s < TX_4FSK_GROUP_SYMBOLS; s++) {
+          size_t age = group * TX_4FSK_GROUP_SYMBOLS + s;
+          if (age < phaseLen)
+            sum += level[(entry >> (2U * s)) & 0x03U] * taps[(SPS - 1U - phase) + SPS * (phaseLen - 1U - age)];
+        }
+
+        table[(group * TX_4FSK_GROUP_ENTRIES + entry) * SPS + phase] = sum;
+      }
+    }
+  }
+
+  return table;
+}
+
+template <uint16_t SPS>
+class C4FSKTX {
+public:
+  static constexpr uint16_t BYTE_SAMPLES = 4U * SPS;
+
+  // Bytes into a burst before its samples no longer depend on what was sent before it
+  static constexpr uint16_t SETTLE_BYTES = 2U;
+
+  C4FSKTX(const q31_t* table) :
+  m_table(table),
+  m_history(0U)
+  {
+  }
+
+  void setTable(const q31_t* table)
+  {
+    m_table = table;
+  }
+
+  // The whole bytes that fit in space samples, as many as a byte at a time writer that stops
+  // with a byte or less of space left would write
+  static uint16_t getBytes(uint16_t space)
+  {
+    return space > 0U ? (space - 1U) / (4U * SPS) : 0U;
+  }
+
+  // The leading bytes of data that are c, when the last four bytes sent were c too. Each of those
+  // gives the same samples as the one before, also after a following filter spanning up to eight
+  // symbols.
+  uint16_t getRun(uint8_t c, const uint8_t* data, uint16_t length) const
+  {
+    if (m_history != c * 0x01010101U)
+      return 0U;
+
+    uint16_t n = 0U;
+    while (n < length && data[n] == c)
+      n++;
+
+    return n;
+  }
+
+  // Moves the history on as if the bytes had been modulated
+  void advance(const uint8_t* data, uint16_t length)
+  {
+    for (uint16_t i = 0U; i < length; i++)
+      m_history = (m_history << 8) | data[i];
+  }
+
+  // Four symbols per byte, most significant first, giving 4 * SPS samples per byte
+  void modulate(const uint8_t* data, uint16_t length, q15_t* out)
+  {
+    const q31_t* table0 = m_table;
+    const q31_t* table1 = m_table + 1U * TX_4FSK_GROUP_ENTRIES * SPS;
+    const q31_t* table2 = m_table + 2U * TX_4FSK_GROUP_ENTRIES * SPS;
+
+    for (uint16_t i = 0U; i < length; i++) {
+      uint8_t c = data[i];
+
+      for (uint8_t j = 0U; j < 4U; j++, c <<= 2) {
+        m_history = (m_history << 2) | (c >> 6);
+
+        const q31_t* p0 = table0 + ((m_history >> 0)  & 0x3FU) * SPS;
+        const q31_t* p1 = table1 + ((m_history >> 6)  & 0x3FU) * SPS;
+        const q31_t* p2 = table2 + ((m_history >> 12) & 0x3FU) * SPS;
+
+        for (uint16_t k = 0U; k < SPS; k++) {
+          q31_t sum = (p0[k] + p1[k] + p2[k]) >> 15;
+          *out++ = q15_t(__SSAT(sum, 16));
+        }
+      }
+    }
+  }
+
+private:
+  const q31_t* m_table;
+  uint32_t     m_history;                  // Newest symbol in the low bits, it starts as -1 symbols rather than silence
+};
+
+#endif
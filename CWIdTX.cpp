@@ -31,6 +31,9 @@ const uint8_t CYCLE_LENGTH = 24U;
 
 const uint8_t DOT_LENGTH = 50U;
 
+// Cycles kept ready in the tone and silence caches
+const uint16_t CACHE_CYCLES = 16U;
+
 const struct {
   uint8_t  c;
   uint32_t pattern;
@@ -87,6 +90,8 @@ const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02
 #define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
 
 CCWIdTX::CCWIdTX() :
+m_tone(STATE_CWID, CACHE_CYCLES * CYCLE_LENGTH),
+m_silence(STATE_CWID, CACHE_CYCLES * CYCLE_LENGTH),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
@@ -100,17 +105,31 @@ void CCWIdTX::process()
     return;
 
   uint16_t space = io.getSpace();
-    
+
   while (space > CYCLE_LENGTH) {
     bool b = READ_BIT1(m_poBuffer, m_poPtr);
-    if (b)
-      io.write(STATE_CWID, TONE, CYCLE_LENGTH);
-    else
-      io.write(STATE_CWID, SILENCE, CYCLE_LENGTH);
 
-    space -= CYCLE_LENGTH;
+    // The cycles left of this dot that fit, in one write
+    uint16_t n = (space - 1U) / CYCLE_LENGTH;
+    if (n > (DOT_LENGTH - m_n))
+      n = DOT_LENGTH - m_n;
+    if (n > CACHE_CYCLES)
+      n = CACHE_CYCLES;
+
+    CTXCache& cache = b ? m_tone : m_silence;
+    if (!cache.isValid()) {
+      q15_t samples[CACHE_CYCLES * CYCLE_LENGTH];
+      for (uint16_t i = 0U; i < CACHE_CYCLES; i++)
+        ::memcpy(samples + i * CYCLE_LENGTH, b ? TONE : SILENCE, CYCLE_LENGTH * sizeof(q15_t));
+
+      cache.store(samples, CACHE_CYCLES * CYCLE_LENGTH);
+    }
+
+    cache.write(0U, n * CYCLE_LENGTH);
+
+    space -= n * CYCLE_LENGTH;
 
-    m_n++;
+    m_n += n;
     if (m_n >= DOT_LENGTH) {
       m_poPtr++;
       m_n = 0U;
@@ -21,6 +21,7 @@
 #define  CWIDTX_H
 
 #include "Config.h"
+#include "TXCache.h"
 
 class CCWIdTX {
 public:
@@ -33,6 +34,8 @@ public:
   void reset();
 
 private:
+  CTXCache m_tone;
+  CTXCache m_silence;
   uint8_t  m_poBuffer[1000U];
   uint16_t m_poLen;
   uint16_t m_poPtr;
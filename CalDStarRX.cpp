@@ -42,7 +42,7 @@ m_ptr(0U)
 {
 }
 
-void CCalDStarRX::samples(const q15_t* samples, uint8_t length)
+void CCalDStarRX::samples(const q15_t* samples, uint16_t length)
 {
   for (uint16_t i = 0U; i < length; i++) {
     bool bit = samples[i] < 0;
@@ -26,7 +26,7 @@ class CCalDStarRX {
 public:
   CCalDStarRX();
 
-  void samples(const q15_t* samples, uint8_t length);
+  void samples(const q15_t* samples, uint16_t length);
 
 private:
   uint32_t m_pll;
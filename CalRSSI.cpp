@@ -29,7 +29,7 @@ m_max(0x0000U)
 {
 }
 
-void CCalRSSI::samples(const uint16_t* rssi, uint8_t length)
+void CCalRSSI::samples(const uint16_t* rssi, uint16_t length)
 {
   for (uint16_t i = 0U; i < length; i++) {
     uint16_t ss = rssi[i];
@@ -25,7 +25,7 @@ class CCalRSSI {
 public:
   CCalRSSI();
 
-  void samples(const uint16_t* rssi, uint8_t length);
+  void samples(const uint16_t* rssi, uint16_t length);
 
 private:
   uint32_t m_count;
@@ -0,0 +1,147 @@
+/*
+ *   Polyphase channelizer for the SoapySX RX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Channelizer.h"
+
+#include <cmath>
+#include <cstring>
+
+CChannelizer::CChannelizer() :
+m_channels(0U),
+m_decimation(1U),
+m_taps(0U),
+m_coeffs(),
+m_state(),
+m_paths(),
+m_count(0U),
+m_odd(false),
+m_fft()
+{
+}
+
+bool CChannelizer::setChannels(uint16_t channels)
+{
+  if (channels < 2U || channels > CHANNELIZER_MAX_CHANNELS || !m_fft.setSize(channels))
+    return false;
+
+  m_channels   = channels;
+  m_decimation = channels / 2U;
+  m_taps       = designPrototype(channels, m_coeffs);
+
+  reset();
+
+  return true;
+}
+
+uint16_t CChannelizer::designPrototype(uint16_t channels, float* coeffs)
+{
+  uint16_t taps   = channels * CHANNELIZER_TAPS_PER_PATH;
+  double   fc     = 0.5 / double(channels);
+  double   centre = double(taps - 1U) / 2.0;
+  double   sum    = 0.0;
+
+  for (uint16_t n = 0U; n < taps; n++) {
+    double x    = double(n) - centre;
+    double sinc = (x == 0.0) ? 1.0 : ::sin(2.0 * M_PI * fc * x) / (2.0 * M_PI * fc * x);
+    double w    = 0.42 - 0.5 * ::cos(2.0 * M_PI * double(n) / double(taps - 1U)) + 0.08 * ::cos(4.0 * M_PI * double(n) / double(taps - 1U));
+
+    coeffs[n] = float(2.0 * fc * sinc * w);
+    sum += coeffs[n];
+  }
+
+  for (uint16_t n = 0U; n < taps; n++)
+    coeffs[n] = float(coeffs[n] / sum);
+
+  return taps;
+}
+
+void CChannelizer::reset()
+{
+  m_count = 0U;
+  m_odd   = false;
+
+  for (uint16_t i = 0U; i < m_taps - 1U + CHANNELIZER_BLOCK_SIZE; i++)
+    m_state[i] = std::complex<float>(0.0F, 0.0F);
+}
+
+uint16_t CChannelizer::process(const std::complex<float>* in, uint16_t length, std::complex<float>* const* out)
+{
+  if (m_channels == 0U)
+    return 0U;
+
+  uint16_t n = 0U;
+
+  while (length > 0U) {
+    uint16_t len = length > CHANNELIZER_BLOCK_SIZE ? CHANNELIZER_BLOCK_SIZE : length;
+
+    n += processBlock(in, len, out, n);
+
+    in     += len;
+    length -= len;
+  }
+
+  return n;
+}
+
+uint16_t CChannelizer::processBlock(const std::complex<float>* in, uint16_t length, std::complex<float>* const* out, uint16_t offset)
+{
+  const uint16_t history = m_taps - 1U;
+
+  ::memcpy(m_state + history, in, length * sizeof(std::complex<float>));
+
+  uint16_t n = 0U;
+
+  for (uint16_t i = 0U; i < length; i++) {
+    if (++m_count < m_decimation)
+      continue;
+    m_count = 0U;
+
+    // Each of the N paths sums every Nth tap against the history, newest sample first
+    const std::complex<float>* x = m_state + history + i;
+    for (uint16_t r = 0U; r < m_channels; r++)
+      m_paths[r] = std::complex<float>(0.0F, 0.0F);
+
+    for (uint16_t p = 0U; p < m_taps; p += m_channels) {
+      const float*               h  = m_coeffs + p;
+      const std::complex<float>* xp = x - p;
+      for (uint16_t r = 0U; r < m_channels; r++)
+        m_paths[r] += h[r] * xp[-int(r)];
+    }
+
+    // The inverse DFT across the paths mixes every channel down to baseband at once
+    m_fft.inverse(m_paths);
+
+    // Decimating by N / 2 leaves channel k rotating by pi * k per output, undo it
+    for (uint16_t k = 0U; k < m_channels; k++) {
+      if (out[k] == NULL)
+        continue;
+
+      bool negate = m_odd && (k & 1U) != 0U;
+      out[k][offset + n] = negate ? -m_paths[k] : m_paths[k];
+    }
+
+    m_odd = !m_odd;
+    n++;
+  }
+
+  ::memmove(m_state, m_state + length, history * sizeof(std::complex<float>));
+
+  return n;
+}
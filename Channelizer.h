@@ -0,0 +1,71 @@
+/*
+ *   Polyphase channelizer for the SoapySX RX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(CHANNELIZER_H)
+#define  CHANNELIZER_H
+
+#include "Globals.h"
+#include "FFT.h"
+
+#include <complex>
+
+const uint16_t CHANNELIZER_MAX_CHANNELS  = FFT_MAX_SIZE;
+const uint16_t CHANNELIZER_TAPS_PER_PATH = 24U;
+
+// Largest input block handled in one pass, longer blocks are split internally
+const uint16_t CHANNELIZER_BLOCK_SIZE = 512U;
+
+// Splits a wideband IQ stream into N channels spaced by fs / N. Each channel is
+// decimated by N / 2, so it comes out at twice the channel spacing and the prototype
+// filter's transition band doesn't alias back into it.
+class CChannelizer {
+public:
+  CChannelizer();
+
+  // The channel count must be a power of two from 2 to CHANNELIZER_MAX_CHANNELS
+  bool setChannels(uint16_t channels);
+
+  void reset();
+
+  uint16_t getChannels() const { return m_channels; }
+  uint16_t getDecimation() const { return m_decimation; }
+
+  // The Blackman windowed low-pass shared with the synthesis bank, cut at half the channel
+  // spacing with unity DC gain. Writes channels * CHANNELIZER_TAPS_PER_PATH taps.
+  static uint16_t designPrototype(uint16_t channels, float* coeffs);
+
+  // Channel k is centred at k * fs / N, channels above N / 2 are the negative offsets.
+  // out holds one buffer per channel, channels with a NULL buffer are not stored.
+  // Returns the number of samples written to each channel.
+  uint16_t process(const std::complex<float>* in, uint16_t length, std::complex<float>* const* out);
+
+private:
+  uint16_t            m_channels;
+  uint16_t            m_decimation;
+  uint16_t            m_taps;
+  float               m_coeffs[CHANNELIZER_MAX_CHANNELS * CHANNELIZER_TAPS_PER_PATH];
+  std::complex<float> m_state[CHANNELIZER_MAX_CHANNELS * CHANNELIZER_TAPS_PER_PATH - 1U + CHANNELIZER_BLOCK_SIZE];
+  std::complex<float> m_paths[CHANNELIZER_MAX_CHANNELS];
+  uint16_t            m_count;
+  bool                m_odd;
+  CFFT                m_fft;
+
+  uint16_t processBlock(const std::complex<float>* in, uint16_t length, std::complex<float>* const* out, uint16_t offset);
+};
+
+#endif
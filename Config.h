@@ -69,4 +69,9 @@
 // To reduce CPU load, you can remove the DC blocker by commenting out the next line
 #define USE_DCBLOCKER
 
+// Samples per symbol the DMR, YSF, P25 and NXDN receivers work at, from 2 to 5. Their matched
+// filter outputs are decimated to this rate before decoding, fewer samples per symbol cuts the
+// decoding load on slower boards at some cost in timing accuracy.
+#define RX_4FSK_SYMBOL_LENGTH 5
+
 #endif
@@ -21,8 +21,24 @@
 
 #include "Config.h"
 #include "DMRDefines.h"
+#include "4FSKRX.h"
 
-const uint16_t DMO_BUFFER_LENGTH_SAMPLES = 1440U;   // 60ms at 24 kHz
+const uint16_t DMO_BUFFER_LENGTH_SYMBOLS = 288U;   // 60ms
+
+struct DMRDMORX_TRAITS {
+  static constexpr const char*   NAME                  = "DMRDMORX";
+  static constexpr uint16_t      BUFFER_LENGTH         = DMO_BUFFER_LENGTH_SYMBOLS;
+  static constexpr uint16_t      SYMBOL_LENGTH         = 1U;
+  static constexpr const int8_t* SYNC_SYMBOLS_VALUES   = DMR_MS_DATA_SYNC_SYMBOLS_VALUES;
+  static constexpr uint16_t      SYNC_LENGTH_SYMBOLS   = DMR_SYNC_LENGTH_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS          = DMR_MS_DATA_SYNC_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS_MASK     = DMR_SYNC_SYMBOLS_MASK;
+  static constexpr uint64_t      SYNC_BITS             = DMR_MS_DATA_SYNC_BITS;
+  static constexpr uint64_t      SYNC_BITS_MASK        = DMR_SYNC_BITS_MASK;
+  static constexpr uint8_t       MAX_SYNC_SYMBOLS_ERRS = 2U;
+  static constexpr q15_t         SCALING_FACTOR        = 19505;      // Q15(0.60)
+  static constexpr uint8_t       AVERAGE_SHIFT         = 2U;
+};
 
 enum DMORX_STATE {
   DMORXS_NONE,
@@ -30,39 +46,32 @@ enum DMORX_STATE {
   DMORXS_DATA
 };
 
-class CDMRDMORX {
+class CDMRDMORX : public C4FSKRX<DMRDMORX_TRAITS> {
 public:
   CDMRDMORX();
 
-  void samples(const q15_t* samples, const uint16_t* rssi, uint8_t length);
+  // Takes one value per symbol, at the symbol centre found by CSymbolTiming
+  void samples(const q15_t* samples, const uint16_t* rssi, uint16_t length);
 
   void setColorCode(uint8_t colorCode);
 
   void reset();
 
 private:
-  uint32_t    m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-  q15_t       m_buffer[DMO_BUFFER_LENGTH_SAMPLES];
-  uint16_t    m_bitPtr;
-  uint16_t    m_dataPtr;
   uint16_t    m_syncPtr;
   uint16_t    m_startPtr;
   uint16_t    m_endPtr;
   q31_t       m_maxCorr;
-  q15_t       m_centre[4U];
-  q15_t       m_threshold[4U];
-  uint8_t     m_averagePtr;
   uint8_t     m_control;
   uint8_t     m_syncCount;
   uint8_t     m_colorCode;
   DMORX_STATE m_state;
   uint8_t     m_n;
   uint8_t     m_type;
-  uint16_t    m_rssi[DMO_BUFFER_LENGTH_SAMPLES];
-  
+  uint16_t    m_rssi[DMO_BUFFER_LENGTH_SYMBOLS];
+
   bool processSample(q15_t sample, uint16_t rssi);
   void correlateSync(bool first);
-  void samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold);
   void writeRSSIData(uint8_t* frame);
 };
 
@@ -23,17 +23,7 @@
 #include "DMRSlotType.h"
 
 #include "Log.h"
-
-// Generated using rcosdesign(0.2, 8, 5, 'sqrt') in MATLAB
-static q15_t RRC_0_2_FILTER[] = {0, 0, 0, 0, 850, 219, -720, -1548, -1795, -1172, 237, 1927, 3120, 3073, 1447, -1431, -4544, -6442,
-                                 -5735, -1633, 5651, 14822, 23810, 30367, 32767, 30367, 23810, 14822, 5651, -1633, -5735, -6442,
-                                 -4544, -1431, 1447, 3073, 3120, 1927, 237, -1172, -1795, -1548, -720, 219, 850}; // numTaps = 45, L = 5
-const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
-
-const q15_t DMR_LEVELA =  1362;
-const q15_t DMR_LEVELB =  454;
-const q15_t DMR_LEVELC = -454;
-const q15_t DMR_LEVELD = -1362;
+#include "TXFilters.h"
 
 const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
@@ -44,19 +34,13 @@ const uint8_t DMR_SYNC = 0x5FU;
 
 CDMRDMOTX::CDMRDMOTX() :
 m_fifo(),
-m_modFilter(),
-m_modState(),
+m_modulator(DMR_MOD_TABLE.data()),
+m_syncCache(STATE_DMR, DMR_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
 m_txDelay(240U)       // 200ms
 {
-  ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-  m_modFilter.L           = DMR_RADIO_SYMBOL_LENGTH;
-  m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = RRC_0_2_FILTER;
-  m_modFilter.pState      = m_modState;
 }
 
 void CDMRDMOTX::process()
@@ -83,20 +67,16 @@ void CDMRDMOTX::process()
   }
 
   if (m_poLen > 0U) {
-    uint16_t space = io.getSpace();
-    
-    while (space > (4U * DMR_RADIO_SYMBOL_LENGTH)) {
-      uint8_t c = m_poBuffer[m_poPtr++];
-
-      writeByte(c);
-
-      space -= 4U * DMR_RADIO_SYMBOL_LENGTH;
-      
-      if (m_poPtr >= m_poLen) {
-        m_poPtr = 0U;
-        m_poLen = 0U;
-        return;
-      }
+    uint16_t count = C4FSKTX<DMR_RADIO_SYMBOL_LENGTH>::getBytes(io.getSpace());
+    if (count > (m_poLen - m_poPtr))
+      count = m_poLen - m_poPtr;
+
+    writeBytes(m_poBuffer + m_poPtr, count);
+    m_poPtr += count;
+
+    if (m_poPtr >= m_poLen) {
+      m_poPtr = 0U;
+      m_poLen = 0U;
     }
   }
 }
@@ -116,33 +96,31 @@ uint8_t CDMRDMOTX::writeData(const uint8_t* data, uint8_t length)
   return 0U;
 }
 
-void CDMRDMOTX::writeByte(uint8_t c)
+void CDMRDMOTX::writeBytes(const uint8_t* data, uint16_t length)
 {
-  q15_t inBuffer[4U];
-  q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
-
-  const uint8_t MASK = 0xC0U;
-
-  for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-    switch (c & MASK) {
-      case 0xC0U:
-        inBuffer[i] = DMR_LEVELA;
-        break;
-      case 0x80U:
-        inBuffer[i] = DMR_LEVELB;
-        break;
-      case 0x00U:
-        inBuffer[i] = DMR_LEVELC;
-        break;
-      default:
-        inBuffer[i] = DMR_LEVELD;
-        break;
-    }
-  }
+  q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+  while (length > 0U) {
+    uint16_t n = length > TX_4FSK_BLOCK_BYTES ? TX_4FSK_BLOCK_BYTES : length;
 
-  io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U);
+    // Once the modulator has settled on the sync its bytes are all the same
+    uint16_t run = m_modulator.getRun(DMR_SYNC, data, n);
+    uint16_t cached = m_syncCache.getLength() / (DMR_RADIO_SYMBOL_LENGTH * 4U);
+    if (run > 0U && cached > 0U) {
+      n = run < cached ? run : cached;
+      m_syncCache.write(0U, DMR_RADIO_SYMBOL_LENGTH * 4U * n);
+    } else {
+      m_modulator.modulate(data, n, outBuffer);
+
+      if (run == n)
+        m_syncCache.store(outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U * n);
+
+      io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U * n);
+    }
+
+    data   += n;
+    length -= n;
+  }
 }
 
 uint8_t CDMRDMOTX::getSpace() const
@@ -22,6 +22,8 @@
 
 #include "Config.h"
 #include "DMRDefines.h"
+#include "4FSKTX.h"
+#include "TXCache.h"
 
 #include "SerialRB.h"
 
@@ -39,14 +41,14 @@ public:
 
 private:
   CSerialRB                        m_fifo;
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+  C4FSKTX<DMR_RADIO_SYMBOL_LENGTH> m_modulator;
+  CTXCache                         m_syncCache;
   uint8_t                          m_poBuffer[1200U];
   uint16_t                         m_poLen;
   uint16_t                         m_poPtr;
   uint32_t                         m_txDelay;
 
-  void writeByte(uint8_t c);
+  void writeBytes(const uint8_t* data, uint16_t length);
 };
 
 #endif
@@ -20,41 +20,42 @@
 #define  DMRDEFINES_H
 
 const unsigned int DMR_RADIO_SYMBOL_LENGTH = 5U;      // At 24 kHz sample rate
+const unsigned int DMR_RX_SYMBOL_LENGTH    = RX_4FSK_SYMBOL_LENGTH;   // After the RX decimator
 
 const unsigned int DMR_FRAME_LENGTH_BYTES   = 33U;
 const unsigned int DMR_FRAME_LENGTH_BITS    = DMR_FRAME_LENGTH_BYTES * 8U;
 const unsigned int DMR_FRAME_LENGTH_SYMBOLS = DMR_FRAME_LENGTH_BYTES * 4U;
-const unsigned int DMR_FRAME_LENGTH_SAMPLES = DMR_FRAME_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_FRAME_LENGTH_SAMPLES = DMR_FRAME_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_SYNC_LENGTH_BYTES   = 6U;
 const unsigned int DMR_SYNC_LENGTH_BITS    = DMR_SYNC_LENGTH_BYTES * 8U;
 const unsigned int DMR_SYNC_LENGTH_SYMBOLS = DMR_SYNC_LENGTH_BYTES * 4U;
-const unsigned int DMR_SYNC_LENGTH_SAMPLES = DMR_SYNC_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_SYNC_LENGTH_SAMPLES = DMR_SYNC_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_EMB_LENGTH_BITS    = 16U;
 const unsigned int DMR_EMB_LENGTH_SYMBOLS = 8U;
-const unsigned int DMR_EMB_LENGTH_SAMPLES = DMR_EMB_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_EMB_LENGTH_SAMPLES = DMR_EMB_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_EMBSIG_LENGTH_BITS    = 32U;
 const unsigned int DMR_EMBSIG_LENGTH_SYMBOLS = 16U;
-const unsigned int DMR_EMBSIG_LENGTH_SAMPLES = DMR_EMBSIG_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_EMBSIG_LENGTH_SAMPLES = DMR_EMBSIG_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_SLOT_TYPE_LENGTH_BITS    = 20U;
 const unsigned int DMR_SLOT_TYPE_LENGTH_SYMBOLS = 10U;
-const unsigned int DMR_SLOT_TYPE_LENGTH_SAMPLES = DMR_SLOT_TYPE_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_SLOT_TYPE_LENGTH_SAMPLES = DMR_SLOT_TYPE_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_INFO_LENGTH_BITS    = 196U;
 const unsigned int DMR_INFO_LENGTH_SYMBOLS = 98U;
-const unsigned int DMR_INFO_LENGTH_SAMPLES = DMR_INFO_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_INFO_LENGTH_SAMPLES = DMR_INFO_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_AUDIO_LENGTH_BITS    = 216U;
 const unsigned int DMR_AUDIO_LENGTH_SYMBOLS = 108U;
-const unsigned int DMR_AUDIO_LENGTH_SAMPLES = DMR_AUDIO_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_AUDIO_LENGTH_SAMPLES = DMR_AUDIO_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const unsigned int DMR_CACH_LENGTH_BYTES   = 3U;
 const unsigned int DMR_CACH_LENGTH_BITS    = DMR_CACH_LENGTH_BYTES * 8U;
 const unsigned int DMR_CACH_LENGTH_SYMBOLS = DMR_CACH_LENGTH_BYTES * 4U;
-const unsigned int DMR_CACH_LENGTH_SAMPLES = DMR_CACH_LENGTH_SYMBOLS * DMR_RADIO_SYMBOL_LENGTH;
+const unsigned int DMR_CACH_LENGTH_SAMPLES = DMR_CACH_LENGTH_SYMBOLS * DMR_RX_SYMBOL_LENGTH;
 
 const uint8_t  DMR_SYNC_BYTES_LENGTH     = 7U;
 const uint8_t  DMR_MS_DATA_SYNC_BYTES[]  = {0x0DU, 0x5DU, 0x7FU, 0x77U, 0xFDU, 0x75U, 0x70U};
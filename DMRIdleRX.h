@@ -21,30 +21,39 @@
 
 #include "Config.h"
 #include "DMRDefines.h"
+#include "4FSKRX.h"
+
+struct DMRIDLERX_TRAITS {
+  static constexpr const char*   NAME                  = "DMRIdleRX";
+  static constexpr uint16_t      BUFFER_LENGTH         = DMR_FRAME_LENGTH_SAMPLES;
+  static constexpr uint16_t      SYMBOL_LENGTH         = DMR_RX_SYMBOL_LENGTH;
+  static constexpr const int8_t* SYNC_SYMBOLS_VALUES   = DMR_MS_DATA_SYNC_SYMBOLS_VALUES;
+  static constexpr uint16_t      SYNC_LENGTH_SYMBOLS   = DMR_SYNC_LENGTH_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS          = DMR_MS_DATA_SYNC_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS_MASK     = DMR_SYNC_SYMBOLS_MASK;
+  static constexpr uint64_t      SYNC_BITS             = DMR_MS_DATA_SYNC_BITS;
+  static constexpr uint64_t      SYNC_BITS_MASK        = DMR_SYNC_BITS_MASK;
+  static constexpr uint8_t       MAX_SYNC_SYMBOLS_ERRS = 2U;
+  static constexpr q15_t         SCALING_FACTOR        = 19505;      // Q15(0.60)
+  static constexpr uint8_t       AVERAGE_SHIFT         = 0U;         // Levels from the latest sync alone
+};
 
-class CDMRIdleRX {
+class CDMRIdleRX : public C4FSKRX<DMRIDLERX_TRAITS> {
 public:
   CDMRIdleRX();
 
-  void samples(const q15_t* samples, uint8_t length);
+  void samples(const q15_t* samples, uint16_t length);
 
   void setColorCode(uint8_t colorCode);
 
   void reset();
 
 private:
-  uint32_t m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-  q15_t    m_buffer[DMR_FRAME_LENGTH_SAMPLES];
-  uint16_t m_bitPtr;
-  uint16_t m_dataPtr;
   uint16_t m_endPtr;
   q31_t    m_maxCorr;
-  q15_t    m_centre;
-  q15_t    m_threshold;
   uint8_t  m_colorCode;
 
   void processSample(q15_t sample);
-  void samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold);
 };
 
 #endif
@@ -27,7 +27,7 @@ m_slot2RX(true)
 {
 }
 
-void CDMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length)
+void CDMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length)
 {
   bool dcd1 = false;
   bool dcd2 = false;
@@ -26,7 +26,7 @@ class CDMRRX {
 public:
   CDMRRX();
 
-  void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length);
+  void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length);
 
   void setColorCode(uint8_t colorCode);
   void setDelay(uint8_t delay);
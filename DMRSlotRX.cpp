@@ -20,42 +20,26 @@
 #include "Globals.h"
 #include "DMRSlotRX.h"
 #include "DMRSlotType.h"
-#include "Utils.h"
 
-const uint16_t SCAN_START = 400U;
-const uint16_t SCAN_END   = 490U;
+const uint16_t SCAN_START = 80U * DMR_RX_SYMBOL_LENGTH;
+const uint16_t SCAN_END   = 98U * DMR_RX_SYMBOL_LENGTH;
 
-const q15_t SCALING_FACTOR = 19505;      // Q15(0.60)
-
-const uint8_t MAX_SYNC_SYMBOLS_ERRS = 2U;
 const uint8_t MAX_SYNC_BYTES_ERRS   = 3U;
 
 const uint8_t MAX_SYNC_LOST_FRAMES  = 13U;
 
-const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-
-const uint16_t NOENDPTR = 9999U;
-
 const uint8_t CONTROL_NONE  = 0x00U;
 const uint8_t CONTROL_VOICE = 0x20U;
 const uint8_t CONTROL_DATA  = 0x40U;
 
 CDMRSlotRX::CDMRSlotRX(bool slot) :
+C4FSKRX(),
 m_slot(slot),
-m_bitBuffer(),
-m_buffer(),
-m_bitPtr(0U),
-m_dataPtr(0U),
 m_syncPtr(0U),
 m_startPtr(0U),
 m_endPtr(NOENDPTR),
 m_delayPtr(0U),
 m_maxCorr(0),
-m_centre(),
-m_threshold(),
-m_averagePtr(0U),
 m_control(CONTROL_NONE),
 m_syncCount(0U),
 m_colorCode(0U),
@@ -78,10 +62,10 @@ void CDMRSlotRX::start()
 
 void CDMRSlotRX::reset()
 {
+  resetRX();
+
   m_syncPtr   = 0U;
-  m_dataPtr   = 0U;
   m_delayPtr  = 0U;
-  m_bitPtr    = 0U;
   m_maxCorr   = 0;
   m_control   = CONTROL_NONE;
   m_syncCount = 0U;
@@ -97,15 +81,11 @@ bool CDMRSlotRX::processSample(q15_t sample, uint16_t rssi)
     return m_state != DMRRXS_NONE;
 
   // Ensure that the buffer doesn't overflow
-  if (m_dataPtr > m_endPtr || m_dataPtr >= 900U)
+  if (m_dataPtr > m_endPtr || m_dataPtr >= DMR_SLOT_BUFFER_LENGTH_SAMPLES)
     return m_state != DMRRXS_NONE;
 
-  m_buffer[m_dataPtr] = sample;
+  write(sample);
   m_rssi[m_dataPtr] = rssi;
-  
-  m_bitBuffer[m_bitPtr] <<= 1;
-  if (sample < 0)
-    m_bitBuffer[m_bitPtr] |= 0x01U;
 
   if (m_state == DMRRXS_NONE) {
     if (m_dataPtr >= SCAN_START && m_dataPtr <= SCAN_END)
@@ -119,14 +99,14 @@ bool CDMRSlotRX::processSample(q15_t sample, uint16_t rssi)
   }
 
   if (m_dataPtr == m_endPtr) {
-    // Find the average centre and threshold values
-    q15_t centre    = (m_centre[0U]    + m_centre[1U]    + m_centre[2U]    + m_centre[3U])    >> 2;
-    q15_t threshold = (m_threshold[0U] + m_threshold[1U] + m_threshold[2U] + m_threshold[3U]) >> 2;
+    // The centre and threshold averaged over the last few syncs
+    q15_t centre    = m_centreVal;
+    q15_t threshold = m_thresholdVal;
 
     uint8_t frame[DMR_FRAME_LENGTH_BYTES + 3U];
     frame[0U] = m_control;
 
-    uint16_t ptr = m_endPtr - DMR_FRAME_LENGTH_SAMPLES + DMR_RADIO_SYMBOL_LENGTH + 1U;
+    uint16_t ptr = m_endPtr - DMR_FRAME_LENGTH_SAMPLES + DMR_RX_SYMBOL_LENGTH + 1U;
     samplesToBits(ptr, DMR_FRAME_LENGTH_SYMBOLS, frame, 8U, centre, threshold);
 
     if (m_control == CONTROL_DATA) {
@@ -221,10 +201,11 @@ bool CDMRSlotRX::processSample(q15_t sample, uint16_t rssi)
     }
   }
 
+  // The slot buffer is filled once per slot from start(), so it is not wrapped like next() does
   m_dataPtr++;
 
   m_bitPtr++;
-  if (m_bitPtr >= DMR_RADIO_SYMBOL_LENGTH)
+  if (m_bitPtr >= DMR_RX_SYMBOL_LENGTH)
     m_bitPtr = 0U;
 
   return m_state != DMRRXS_NONE;
@@ -232,145 +213,42 @@ bool CDMRSlotRX::processSample(q15_t sample, uint16_t rssi)
 
 void CDMRSlotRX::correlateSync(bool first)
 {
-  uint8_t errs = countBits32((m_bitBuffer[m_bitPtr] & DMR_SYNC_SYMBOLS_MASK) ^ DMR_MS_DATA_SYNC_SYMBOLS);
+  uint8_t errs = countSyncSymbolErrs();
 
   // The voice sync is the complement of the data sync
-  bool data  = (errs <= MAX_SYNC_SYMBOLS_ERRS);
-  bool voice = (errs >= (DMR_SYNC_LENGTH_SYMBOLS - MAX_SYNC_SYMBOLS_ERRS));
+  bool data  = (errs <= DMRSLOTRX_TRAITS::MAX_SYNC_SYMBOLS_ERRS);
+  bool voice = (errs >= (DMR_SYNC_LENGTH_SYMBOLS - DMRSLOTRX_TRAITS::MAX_SYNC_SYMBOLS_ERRS));
 
   if (data || voice) {
-    uint16_t ptr = m_dataPtr - DMR_SYNC_LENGTH_SAMPLES + DMR_RADIO_SYMBOL_LENGTH;
-
-    q31_t corr = 0;
-    q15_t min =  16000;
-    q15_t max = -16000;
-
-    for (uint8_t i = 0U; i < DMR_SYNC_LENGTH_SYMBOLS; i++) {
-      q15_t val = m_buffer[ptr];
-
-      if (val > max)
-        max = val;
-      if (val < min)
-        min = val;
-
-      int8_t corrVal;
-      if (data)
-        corrVal = DMR_MS_DATA_SYNC_SYMBOLS_VALUES[i];
-      else
-        corrVal = DMR_MS_VOICE_SYNC_SYMBOLS_VALUES[i];
-
-      switch (corrVal) {
-      case +3:
-        corr -= (val + val + val);
-        break;
-      case +1:
-        corr -= val;
-        break;
-      case -1:
-        corr += val;
-        break;
-      default:  // -3
-        corr += (val + val + val);
-        break;
-      }
+    q15_t min, max;
+    q31_t corr = correlate(min, max);
 
-      ptr += DMR_RADIO_SYMBOL_LENGTH;
-    }
+    // Correlating against the data sync, so negate it for the voice sync
+    if (!data)
+      corr = -corr;
 
     if (corr > m_maxCorr) {
-      q15_t centre = (max + min) >> 1;
-
-      q31_t v1 = (max - centre) * SCALING_FACTOR;
-      q15_t threshold = q15_t(v1 >> 15);
-
-      uint8_t sync[DMR_SYNC_BYTES_LENGTH];
-      uint16_t ptr = m_dataPtr - DMR_SYNC_LENGTH_SAMPLES + DMR_RADIO_SYMBOL_LENGTH;
-      samplesToBits(ptr, DMR_SYNC_LENGTH_SYMBOLS, sync, 4U, centre, threshold);
-
-      if (data) {
-        uint8_t errs = 0U;
-        for (uint8_t i = 0U; i < DMR_SYNC_BYTES_LENGTH; i++)
-          errs += countBits8((sync[i] & DMR_SYNC_BYTES_MASK[i]) ^ DMR_MS_DATA_SYNC_BYTES[i]);
-
-        if (errs <= MAX_SYNC_BYTES_ERRS) {
-          if (first) {
-            m_threshold[0U] = m_threshold[1U] = m_threshold[2U] = m_threshold[3U] = threshold;
-            m_centre[0U]    = m_centre[1U]    = m_centre[2U]    = m_centre[3U]    = centre;
-            m_averagePtr    = 0U;
-          } else {
-            m_threshold[m_averagePtr] = threshold;
-            m_centre[m_averagePtr]    = centre;
-
-            m_averagePtr++;
-            if (m_averagePtr >= 4U)
-              m_averagePtr = 0U;
-          }
-
-          m_maxCorr  = corr;
-          m_control  = CONTROL_DATA;
-          m_syncPtr  = m_dataPtr;
-          m_startPtr = m_dataPtr - DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U - DMR_INFO_LENGTH_SAMPLES / 2U - DMR_SYNC_LENGTH_SAMPLES;
-          m_endPtr   = m_dataPtr + DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U + DMR_INFO_LENGTH_SAMPLES / 2U - 1U;
-        }
-      } else {  // if (voice)
-        uint8_t errs = 0U;
-        for (uint8_t i = 0U; i < DMR_SYNC_BYTES_LENGTH; i++)
-          errs += countBits8((sync[i] & DMR_SYNC_BYTES_MASK[i]) ^ DMR_MS_VOICE_SYNC_BYTES[i]);
-
-        if (errs <= MAX_SYNC_BYTES_ERRS) {
-          if (first) {
-            m_threshold[0U] = m_threshold[1U] = m_threshold[2U] = m_threshold[3U] = threshold;
-            m_centre[0U]    = m_centre[1U]    = m_centre[2U]    = m_centre[3U]    = centre;
-            m_averagePtr    = 0U;
-          } else {
-            m_threshold[m_averagePtr] = threshold;
-            m_centre[m_averagePtr]    = centre;
-
-            m_averagePtr++;
-            if (m_averagePtr >= 4U)
-              m_averagePtr = 0U;
-          }
-
-          m_maxCorr  = corr;
-          m_control  = CONTROL_VOICE;
-          m_syncPtr  = m_dataPtr;
-          m_startPtr = m_dataPtr - DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U - DMR_INFO_LENGTH_SAMPLES / 2U - DMR_SYNC_LENGTH_SAMPLES;
-          m_endPtr   = m_dataPtr + DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U + DMR_INFO_LENGTH_SAMPLES / 2U - 1U;
-        }
+      q15_t centre, threshold;
+      syncLevels(min, max, centre, threshold);
+
+      uint64_t bits = syncToBits(syncStartPtr(), centre, threshold);
+      uint8_t errs  = countSyncErrs(bits, data ? DMR_MS_DATA_SYNC_BITS : DMR_MS_VOICE_SYNC_BITS, DMR_SYNC_BITS_MASK);
+
+      if (errs <= MAX_SYNC_BYTES_ERRS) {
+        if (first)
+          m_averagePtr = NOAVEPTR;
+        averageLevels(centre, threshold);
+
+        m_maxCorr  = corr;
+        m_control  = data ? CONTROL_DATA : CONTROL_VOICE;
+        m_syncPtr  = m_dataPtr;
+        m_startPtr = m_dataPtr - DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U - DMR_INFO_LENGTH_SAMPLES / 2U - DMR_SYNC_LENGTH_SAMPLES;
+        m_endPtr   = m_dataPtr + DMR_SLOT_TYPE_LENGTH_SAMPLES / 2U + DMR_INFO_LENGTH_SAMPLES / 2U - 1U;
       }
     }
   }
 }
 
-void CDMRSlotRX::samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold)
-{
-  for (uint8_t i = 0U; i < count; i++, start += DMR_RADIO_SYMBOL_LENGTH) {
-    q15_t sample = m_buffer[start] - centre;
-
-    if (sample < -threshold) {
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-    } else if (sample < 0) {
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-    } else if (sample < threshold) {
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-    } else {
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-    }
-  }
-}
-
 void CDMRSlotRX::setColorCode(uint8_t colorCode)
 {
   m_colorCode = colorCode;
@@ -378,7 +256,8 @@ void CDMRSlotRX::setColorCode(uint8_t colorCode)
 
 void CDMRSlotRX::setDelay(uint8_t delay)
 {
-  m_delay = delay;
+  // The host gives the delay in samples at 24 kHz
+  m_delay = (delay * DMR_RX_SYMBOL_LENGTH + DMR_RADIO_SYMBOL_LENGTH / 2U) / DMR_RADIO_SYMBOL_LENGTH;
 }
 
 void CDMRSlotRX::writeRSSIData(uint8_t* frame)
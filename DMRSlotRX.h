@@ -21,6 +21,24 @@
 
 #include "Config.h"
 #include "DMRDefines.h"
+#include "4FSKRX.h"
+
+const uint16_t DMR_SLOT_BUFFER_LENGTH_SAMPLES = 180U * DMR_RX_SYMBOL_LENGTH;   // 37.5ms
+
+struct DMRSLOTRX_TRAITS {
+  static constexpr const char*   NAME                  = "DMRSlotRX";
+  static constexpr uint16_t      BUFFER_LENGTH         = DMR_SLOT_BUFFER_LENGTH_SAMPLES;
+  static constexpr uint16_t      SYMBOL_LENGTH         = DMR_RX_SYMBOL_LENGTH;
+  static constexpr const int8_t* SYNC_SYMBOLS_VALUES   = DMR_MS_DATA_SYNC_SYMBOLS_VALUES;
+  static constexpr uint16_t      SYNC_LENGTH_SYMBOLS   = DMR_SYNC_LENGTH_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS          = DMR_MS_DATA_SYNC_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS_MASK     = DMR_SYNC_SYMBOLS_MASK;
+  static constexpr uint64_t      SYNC_BITS             = DMR_MS_DATA_SYNC_BITS;
+  static constexpr uint64_t      SYNC_BITS_MASK        = DMR_SYNC_BITS_MASK;
+  static constexpr uint8_t       MAX_SYNC_SYMBOLS_ERRS = 2U;
+  static constexpr q15_t         SCALING_FACTOR        = 19505;      // Q15(0.60)
+  static constexpr uint8_t       AVERAGE_SHIFT         = 2U;
+};
 
 enum DMRRX_STATE {
   DMRRXS_NONE,
@@ -28,7 +46,7 @@ enum DMRRX_STATE {
   DMRRXS_DATA
 };
 
-class CDMRSlotRX {
+class CDMRSlotRX : public C4FSKRX<DMRSLOTRX_TRAITS> {
 public:
   CDMRSlotRX(bool slot);
 
@@ -43,18 +61,11 @@ public:
 
 private:
   bool        m_slot;
-  uint32_t    m_bitBuffer[DMR_RADIO_SYMBOL_LENGTH];
-  q15_t       m_buffer[900U];
-  uint16_t    m_bitPtr;
-  uint16_t    m_dataPtr;
   uint16_t    m_syncPtr;
   uint16_t    m_startPtr;
   uint16_t    m_endPtr;
   uint16_t    m_delayPtr;
   q31_t       m_maxCorr;
-  q15_t       m_centre[4U];
-  q15_t       m_threshold[4U];
-  uint8_t     m_averagePtr;
   uint8_t     m_control;
   uint8_t     m_syncCount;
   uint8_t     m_colorCode;
@@ -62,10 +73,9 @@ private:
   DMRRX_STATE m_state;
   uint8_t     m_n;
   uint8_t     m_type;
-  uint16_t    m_rssi[900U];
+  uint16_t    m_rssi[DMR_SLOT_BUFFER_LENGTH_SAMPLES];
 
   void correlateSync(bool first);
-  void samplesToBits(uint16_t start, uint8_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold);
   void writeRSSIData(uint8_t* frame);
 };
 
@@ -23,17 +23,7 @@
 #include "DMRSlotType.h"
 
 #include "Log.h"
-
-// Generated using rcosdesign(0.2, 8, 5, 'sqrt') in MATLAB
-static q15_t RRC_0_2_FILTER[] = {0, 0, 0, 0, 850, 219, -720, -1548, -1795, -1172, 237, 1927, 3120, 3073, 1447, -1431, -4544, -6442,
-                                 -5735, -1633, 5651, 14822, 23810, 30367, 32767, 30367, 23810, 14822, 5651, -1633, -5735, -6442,
-                                 -4544, -1431, 1447, 3073, 3120, 1927, 237, -1172, -1795, -1548, -720, 219, 850}; // numTaps = 45, L = 5
-const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
-
-const q15_t DMR_LEVELA =  1362;
-const q15_t DMR_LEVELB =  454;
-const q15_t DMR_LEVELC = -454;
-const q15_t DMR_LEVELD = -1362;
+#include "TXFilters.h"
 
 // The PR FILL and BS Data Sync pattern.
 const uint8_t IDLE_DATA[] =
@@ -50,6 +40,8 @@ const uint8_t CACH_INTERLEAVE[] =
 const uint8_t EMPTY_SHORT_LC[] = 
         {0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
 
+const uint8_t DMR_CAL_PATTERN = 0x5FU;    // +3, +3, -3, -3
+
 const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
@@ -60,8 +52,9 @@ const uint32_t ABORT_COUNT = 6U;
 
 CDMRTX::CDMRTX() :
 m_fifo(),
-m_modFilter(),
-m_modState(),
+m_modulator(DMR_MOD_TABLE.data()),
+m_idleCache(STATE_DMR, DMR_RADIO_SYMBOL_LENGTH * 4U * DMR_FRAME_LENGTH_BYTES),
+m_calCache(STATE_DMR, DMR_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES),
 m_state(DMRTXSTATE_IDLE),
 m_idle(),
 m_cachPtr(0U),
@@ -71,17 +64,11 @@ m_markBuffer(),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
+m_poIdle(false),
 m_frameCount(0U),
 m_abortCount(),
 m_abort()
 {
-  ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-  m_modFilter.L           = DMR_RADIO_SYMBOL_LENGTH;
-  m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = RRC_0_2_FILTER;
-  m_modFilter.pState      = m_modState;
-
   ::memcpy(m_newShortLC, EMPTY_SHORT_LC, 12U);
   ::memcpy(m_shortLC,    EMPTY_SHORT_LC, 12U);
 
@@ -128,22 +115,19 @@ void CDMRTX::process()
   }
 
   if (m_poLen > 0U) {
-    uint16_t space = io.getSpace();
-    
-    while (space > (4U * DMR_RADIO_SYMBOL_LENGTH)) {
-      uint8_t c = m_poBuffer[m_poPtr];
-      uint8_t m = m_markBuffer[m_poPtr];
-      m_poPtr++;
-
-      writeByte(c, m);
-
-      space -= 4U * DMR_RADIO_SYMBOL_LENGTH;
-      
-      if (m_poPtr >= m_poLen) {
-        m_poPtr = 0U;
-        m_poLen = 0U;
-        return;
-      }
+    uint16_t count = C4FSKTX<DMR_RADIO_SYMBOL_LENGTH>::getBytes(io.getSpace());
+    if (count > (m_poLen - m_poPtr))
+      count = m_poLen - m_poPtr;
+
+    if (m_poIdle)
+      m_idleCache.writeBurst(m_modulator, m_poBuffer, m_poLen, m_poPtr, count);
+    else
+      writeBytes(m_poBuffer + m_poPtr, m_markBuffer + m_poPtr, count);
+    m_poPtr += count;
+
+    if (m_poPtr >= m_poLen) {
+      m_poPtr = 0U;
+      m_poLen = 0U;
     }
   }
 }
@@ -250,37 +234,44 @@ void CDMRTX::setCal(bool start)
   m_state = start ? DMRTXSTATE_CAL : DMRTXSTATE_IDLE;
 }
 
-void CDMRTX::writeByte(uint8_t c, uint8_t control)
+void CDMRTX::writeBytes(const uint8_t* data, const uint8_t* control, uint16_t length)
 {
-  q15_t inBuffer[4U];
-  q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
+  q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
+  uint8_t controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
+
+  while (length > 0U) {
+    uint16_t n = length > TX_4FSK_BLOCK_BYTES ? TX_4FSK_BLOCK_BYTES : length;
+
+    // Once the modulator has settled on the calibration pattern its bytes are all the same, the
+    // cache holds no marks so the run stops at the first
+    uint16_t run = m_modulator.getRun(DMR_CAL_PATTERN, data, n);
+    for (uint16_t i = 0U; i < run; i++) {
+      if (control[i] != MARK_NONE)
+        run = i;
+    }
 
-  const uint8_t MASK = 0xC0U;
+    uint16_t cached = m_calCache.getLength() / (DMR_RADIO_SYMBOL_LENGTH * 4U);
+    if (run > 0U && cached > 0U) {
+      n = run < cached ? run : cached;
+      m_calCache.write(0U, DMR_RADIO_SYMBOL_LENGTH * 4U * n);
+    } else {
+      m_modulator.modulate(data, n, outBuffer);
 
-  for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-    switch (c & MASK) {
-      case 0xC0U:
-        inBuffer[i] = DMR_LEVELA;
-        break;
-      case 0x80U:
-        inBuffer[i] = DMR_LEVELB;
-        break;
-      case 0x00U:
-        inBuffer[i] = DMR_LEVELC;
-        break;
-      default:
-        inBuffer[i] = DMR_LEVELD;
-        break;
-    }
-  }
+      if (run == n)
+        m_calCache.store(outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U * n);
 
-  uint8_t controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
-  ::memset(controlBuffer, MARK_NONE, DMR_RADIO_SYMBOL_LENGTH * 4U * sizeof(uint8_t));
-  controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 2U] = control;  
+      // Each byte's mark lands on its middle sample
+      ::memset(controlBuffer, MARK_NONE, DMR_RADIO_SYMBOL_LENGTH * 4U * n * sizeof(uint8_t));
+      for (uint16_t i = 0U; i < n; i++)
+        controlBuffer[DMR_RADIO_SYMBOL_LENGTH * (4U * i + 2U)] = control[i];
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+      io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U * n, controlBuffer);
+    }
 
-  io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U, controlBuffer);
+    data    += n;
+    control += n;
+    length  -= n;
+  }
 }
 
 uint8_t CDMRTX::getSpace1() const
@@ -295,6 +286,8 @@ uint8_t CDMRTX::getSpace2() const
 
 void CDMRTX::createData(uint8_t slotIndex)
 {
+  m_poIdle = false;
+
   if (m_fifo[slotIndex].getData() >= DMR_FRAME_LENGTH_BYTES && m_frameCount >= STARTUP_COUNT && m_abortCount[slotIndex] >= ABORT_COUNT) {
     for (unsigned int i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++) {
       m_poBuffer[i]   = m_fifo[slotIndex].get();
@@ -307,6 +300,8 @@ void CDMRTX::createData(uint8_t slotIndex)
       m_poBuffer[i]   = m_idle[i];
       m_markBuffer[i] = MARK_NONE;
     }
+
+    m_poIdle = true;
   }
 
   m_poLen = DMR_FRAME_LENGTH_BYTES;
@@ -315,10 +310,12 @@ void CDMRTX::createData(uint8_t slotIndex)
 
 void CDMRTX::createCal()
 {
+  m_poIdle = false;
+
   // 1.2 kHz sine wave generation
   if (m_modemState == STATE_DMRCAL) {
     for (unsigned int i = 0U; i < DMR_FRAME_LENGTH_BYTES; i++) {
-      m_poBuffer[i]   = 0x5FU;              // +3, +3, -3, -3 pattern for deviation cal.
+      m_poBuffer[i]   = DMR_CAL_PATTERN;    // +3, +3, -3, -3 pattern for deviation cal.
       m_markBuffer[i] = MARK_NONE;
     }
 
@@ -347,6 +344,8 @@ void CDMRTX::createCal()
 
 void CDMRTX::createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex)
 {
+  m_poIdle = false;
+
   m_frameCount++;
   m_abortCount[0U]++;
   m_abortCount[1U]++;
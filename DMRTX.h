@@ -22,6 +22,8 @@
 
 #include "Config.h"
 #include "DMRDefines.h"
+#include "4FSKTX.h"
+#include "TXCache.h"
 
 #include "SerialRB.h"
 
@@ -60,8 +62,9 @@ public:
 
 private:
   CSerialRB                        m_fifo[2U];
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+  C4FSKTX<DMR_RADIO_SYMBOL_LENGTH> m_modulator;
+  CTXCache                         m_idleCache;
+  CTXCache                         m_calCache;
   DMRTXSTATE                       m_state;
   uint8_t                          m_idle[DMR_FRAME_LENGTH_BYTES];
   uint8_t                          m_cachPtr;
@@ -71,6 +74,7 @@ private:
   uint8_t                          m_poBuffer[40U];
   uint16_t                         m_poLen;
   uint16_t                         m_poPtr;
+  bool                             m_poIdle;
   uint32_t                         m_frameCount;
   uint32_t                         m_abortCount[2U];
   bool                             m_abort[2U];
@@ -78,7 +82,7 @@ private:
   void createData(uint8_t slotIndex);
   void createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex);
   void createCal();
-  void writeByte(uint8_t c, uint8_t control);
+  void writeBytes(const uint8_t* data, const uint8_t* control, uint16_t length);
 };
 
 #endif
@@ -22,18 +22,12 @@
 #include "DStarTX.h"
 
 #include "DStarDefines.h"
+#include "TXFilters.h"
 
 const uint8_t BIT_SYNC = 0xAAU;
 
 const uint8_t FRAME_SYNC[] = {0xEAU, 0xA6U, 0x00U};
 
-// Generated using gaussfir(0.35, 1, 5) in MATLAB
-static q15_t GAUSSIAN_0_35_FILTER[] = {0, 0, 0, 0, 1001, 3514, 9333, 18751, 28499, 32767, 28499, 18751, 9333, 3514, 1001}; // numTaps = 15, L = 5
-const uint16_t GAUSSIAN_0_35_FILTER_PHASE_LEN = 3U; // phaseLength = numTaps/L
-
-const q15_t DSTAR_LEVEL0 = -841;
-const q15_t DSTAR_LEVEL1 =  841;
-
 const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
 const uint8_t INTERLEAVE_TABLE_TX[] = {
@@ -189,19 +183,15 @@ const uint8_t DSTAR_EOT    = 0x02U;
 
 CDStarTX::CDStarTX() :
 m_buffer(),
-m_modFilter(),
-m_modState(),
+m_modulator(DSTAR_MOD_TABLE.data()),
+m_syncCache(STATE_DSTAR, DSTAR_RADIO_BIT_LENGTH * 8U * TX_GMSK_BLOCK_BYTES),
+m_eotCache(STATE_DSTAR, DSTAR_RADIO_BIT_LENGTH * 8U * DSTAR_EOT_LENGTH_BYTES * 3U),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
+m_poEOT(false),
 m_txDelay(60U)       // 100ms
 {
-  ::memset(m_modState, 0x00U, 20U * sizeof(q15_t));
-
-  m_modFilter.L           = DSTAR_RADIO_BIT_LENGTH;
-  m_modFilter.phaseLength = GAUSSIAN_0_35_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = GAUSSIAN_0_35_FILTER;
-  m_modFilter.pState      = m_modState;
 }
 
 void CDStarTX::process()
@@ -235,6 +225,7 @@ void CDStarTX::process()
     }
 
     m_poPtr = 0U;
+    m_poEOT = false;
   }
  
   if (type == DSTAR_DATA && m_poLen == 0U) {
@@ -245,6 +236,7 @@ void CDStarTX::process()
       m_poBuffer[m_poLen++] = m_buffer.get();
 
     m_poPtr = 0U;
+    m_poEOT = false;
   }
 
   if (type == DSTAR_EOT && m_poLen == 0U) {
@@ -257,22 +249,23 @@ void CDStarTX::process()
     }
      
     m_poPtr = 0U;
+    m_poEOT = true;
   }
 
   if (m_poLen > 0U) {
-    uint16_t space = io.getSpace();
-    
-    while (space > (8U * DSTAR_RADIO_BIT_LENGTH)) {
-      uint8_t c = m_poBuffer[m_poPtr++];
-      writeByte(c);
+    uint16_t count = CGMSKTX<DSTAR_RADIO_BIT_LENGTH>::getBytes(io.getSpace());
+    if (count > (m_poLen - m_poPtr))
+      count = m_poLen - m_poPtr;
 
-      space -= 8U * DSTAR_RADIO_BIT_LENGTH;
-      
-      if (m_poPtr >= m_poLen) {
-        m_poPtr = 0U;
-        m_poLen = 0U;
-        return;
-      }
+    if (m_poEOT)
+      m_eotCache.writeBurst(m_modulator, m_poBuffer, m_poLen, m_poPtr, count);
+    else
+      writeBytes(m_poBuffer + m_poPtr, count);
+    m_poPtr += count;
+
+    if (m_poPtr >= m_poLen) {
+      m_poPtr = 0U;
+      m_poLen = 0U;
     }
   }
 }
@@ -409,25 +402,31 @@ void CDStarTX::txHeader(const uint8_t* in, uint8_t* out) const
     out[i] ^= SCRAMBLE_TABLE_TX[i];
 }
 
-void CDStarTX::writeByte(uint8_t c)
+void CDStarTX::writeBytes(const uint8_t* data, uint16_t length)
 {
-  q15_t inBuffer[8U];
-  q15_t outBuffer[DSTAR_RADIO_BIT_LENGTH * 8U];
+  q15_t outBuffer[DSTAR_RADIO_BIT_LENGTH * 8U * TX_GMSK_BLOCK_BYTES];
 
-  uint8_t mask = 0x01U;
+  while (length > 0U) {
+    uint16_t n = length > TX_GMSK_BLOCK_BYTES ? TX_GMSK_BLOCK_BYTES : length;
 
-  for (uint8_t i = 0U; i < 8U; i++) {
-    if ((c & mask) == mask)
-      inBuffer[i] = DSTAR_LEVEL0;
-    else
-      inBuffer[i] = DSTAR_LEVEL1;
+    // Once the modulator has settled on the bit sync its bytes are all the same
+    uint16_t run = m_modulator.getRun(BIT_SYNC, data, n);
+    uint16_t cached = m_syncCache.getLength() / (DSTAR_RADIO_BIT_LENGTH * 8U);
+    if (run > 0U && cached > 0U) {
+      n = run < cached ? run : cached;
+      m_syncCache.write(0U, DSTAR_RADIO_BIT_LENGTH * 8U * n);
+    } else {
+      m_modulator.modulate(data, n, outBuffer);
 
-    mask <<= 1;
-  }
+      if (run == n)
+        m_syncCache.store(outBuffer, DSTAR_RADIO_BIT_LENGTH * 8U * n);
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 8U);
-  
-  io.write(STATE_DSTAR, outBuffer, DSTAR_RADIO_BIT_LENGTH * 8U);
+      io.write(STATE_DSTAR, outBuffer, DSTAR_RADIO_BIT_LENGTH * 8U * n);
+    }
+
+    data   += n;
+    length -= n;
+  }
 }
 
 void CDStarTX::setTXDelay(uint8_t delay)
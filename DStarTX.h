@@ -20,6 +20,9 @@
 #define  DSTARTX_H
 
 #include "Config.h"
+#include "DStarDefines.h"
+#include "GMSKTX.h"
+#include "TXCache.h"
 
 #include "SerialRB.h"
 
@@ -39,15 +42,17 @@ public:
 
 private:
   CSerialRB                        m_buffer;
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  q15_t                            m_modState[20U];    // blockSize + phaseLength - 1, 8 + 9 - 1 plus some spare
+  CGMSKTX<DSTAR_RADIO_BIT_LENGTH>  m_modulator;
+  CTXCache                         m_syncCache;
+  CTXCache                         m_eotCache;
   uint8_t                          m_poBuffer[600U];
   uint16_t                         m_poLen;
   uint16_t                         m_poPtr;
+  bool                             m_poEOT;
   uint16_t                         m_txDelay;          // In bytes
 
   void txHeader(const uint8_t* in, uint8_t* out) const;
-  void writeByte(uint8_t c);
+  void writeBytes(const uint8_t* data, uint16_t length);
 };
 
 #endif
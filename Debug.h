@@ -23,11 +23,12 @@
 #include "Globals.h"
 #include "Log.h"
 
-#define  DEBUG1(a)          LogDebug((a))
-#define  DEBUG2(a,b)        LogDebug((a),(b))
-#define  DEBUG3(a,b,c)      LogDebug((a),(b),(c))
-#define  DEBUG4(a,b,c,d)    LogDebug((a),(b),(c),(d))
-#define  DEBUG5(a,b,c,d,e)  LogDebug((a),(b),(c),(d),(e))
+#define  DEBUG1(a)            LogDebug((a))
+#define  DEBUG2(a,b)          LogDebug((a),(b))
+#define  DEBUG3(a,b,c)        LogDebug((a),(b),(c))
+#define  DEBUG4(a,b,c,d)      LogDebug((a),(b),(c),(d))
+#define  DEBUG5(a,b,c,d,e)    LogDebug((a),(b),(c),(d),(e))
+#define  DEBUG6(a,b,c,d,e,f)  LogDebug((a),(b),(c),(d),(e),(f))
 
 #endif
 
@@ -0,0 +1,209 @@
+/*
+ *   CIC and half-band decimation chain for wideband SDR sample rates
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Decimator.h"
+
+#include <cmath>
+
+// Generated using a 19 tap Kaiser windowed sinc (beta 7) at a quarter of the sample rate.
+// Only the odd taps either side of the centre are non-zero, better than 69 dB rejection
+// from 0.375 of the input rate for a pass band up to 0.125.
+const q15_t    HALFBAND_CENTRE   = 16384;
+const q15_t    HALFBAND_COEFFS[] = {10023, -2403, 706, -141, 7};
+const uint16_t HALFBAND_MIDDLE   = (HALFBAND_TAPS - 1U) / 2U;
+
+CDecimator::CDecimator() :
+m_cicDecimation(1U),
+m_halfBands(0U),
+m_cicScale(32768),
+m_cicShift(0U),
+m_cicCount(0U),
+m_integI(),
+m_integQ(),
+m_combI(),
+m_combQ(),
+m_hbStateI(),
+m_hbStateQ(),
+m_hbSkip()
+{
+}
+
+uint32_t CDecimator::setRates(uint32_t inRate, uint32_t minOutRate)
+{
+  uint32_t maxDecimation = (minOutRate > 0U) ? inRate / minOutRate : 1U;
+
+  // At least two half-band stages behind the CIC to clean up its aliasing and droop, more
+  // only when the CIC on its own would need too large a factor
+  uint8_t halfBands = 0U;
+  while (halfBands < HALFBAND_MAX_STAGES && (2U << halfBands) <= maxDecimation &&
+         (halfBands < 2U || (maxDecimation >> halfBands) > CIC_MAX_DECIMATION))
+    halfBands++;
+
+  uint32_t cic = maxDecimation >> halfBands;
+  if (cic > CIC_MAX_DECIMATION)
+    cic = CIC_MAX_DECIMATION;
+  if (cic < 1U)
+    cic = 1U;
+
+  // Prefer an exact output rate so that the rational stage gets a small L/M
+  while (cic > 1U && (inRate % (cic << halfBands)) != 0U)
+    cic--;
+  while (halfBands > 0U && (inRate % (cic << halfBands)) != 0U)
+    halfBands--;
+
+  m_cicDecimation = uint16_t(cic);
+  m_halfBands     = halfBands;
+
+  // The CIC gain is R^N, normalise it with a shift and a q15 trim
+  double gain = ::pow(double(m_cicDecimation), double(CIC_STAGES));
+  m_cicShift  = uint8_t(::ceil(::log2(gain)));
+  m_cicScale  = int32_t(::lround(32768.0 * ::pow(2.0, double(m_cicShift)) / gain));
+
+  reset();
+
+  return inRate / (uint32_t(m_cicDecimation) << m_halfBands);
+}
+
+void CDecimator::reset()
+{
+  m_cicCount = 0U;
+
+  ::memset(m_integI,   0x00U, sizeof(m_integI));
+  ::memset(m_integQ,   0x00U, sizeof(m_integQ));
+  ::memset(m_combI,    0x00U, sizeof(m_combI));
+  ::memset(m_combQ,    0x00U, sizeof(m_combQ));
+  ::memset(m_hbStateI, 0x00U, sizeof(m_hbStateI));
+  ::memset(m_hbStateQ, 0x00U, sizeof(m_hbStateQ));
+  ::memset(m_hbSkip,   0x00U, sizeof(m_hbSkip));
+}
+
+uint16_t CDecimator::process(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ)
+{
+  uint16_t total = 0U;
+
+  while (length > 0U) {
+    uint16_t n = length > DECIMATOR_BLOCK_SIZE ? DECIMATOR_BLOCK_SIZE : length;
+
+    total += processBlock(iq, n, outI + total, outQ + total);
+
+    iq     += 2U * n;
+    length -= n;
+  }
+
+  return total;
+}
+
+uint16_t CDecimator::processBlock(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ)
+{
+  uint16_t n = cic(iq, length, outI, outQ);
+
+  // Each half-band stage works in place on the previous stage's output
+  for (uint8_t s = 0U; s < m_halfBands; s++) {
+    uint8_t skip = m_hbSkip[s];
+
+    halfBand(m_hbStateI[s], outI, n, outI, skip);
+    halfBand(m_hbStateQ[s], outQ, n, outQ, skip);
+
+    // Outputs are taken at skip, skip + 2, ... so work out where the next block starts
+    uint16_t count = (n > skip) ? (n - skip + 1U) / 2U : 0U;
+    m_hbSkip[s] = uint8_t(skip + 2U * count - n);
+
+    n = count;
+  }
+
+  return n;
+}
+
+uint16_t CDecimator::cic(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ)
+{
+  if (m_cicDecimation == 1U) {
+    for (uint16_t i = 0U; i < length; i++) {
+      outI[i] = iq[2U * i + 0U];
+      outQ[i] = iq[2U * i + 1U];
+    }
+
+    return length;
+  }
+
+  // Unsigned arithmetic, the integrators are allowed to wrap
+  uint32_t i0 = m_integI[0U], i1 = m_integI[1U], i2 = m_integI[2U], i3 = m_integI[3U];
+  uint32_t q0 = m_integQ[0U], q1 = m_integQ[1U], q2 = m_integQ[2U], q3 = m_integQ[3U];
+
+  uint16_t count = m_cicCount;
+  uint8_t  shift = m_cicShift + 15U;
+  uint16_t n = 0U;
+
+  for (uint16_t i = 0U; i < length; i++) {
+    i0 += uint32_t(int32_t(iq[2U * i + 0U])); i1 += i0; i2 += i1; i3 += i2;
+    q0 += uint32_t(int32_t(iq[2U * i + 1U])); q1 += q0; q2 += q1; q3 += q2;
+
+    count++;
+    if (count < m_cicDecimation)
+      continue;
+    count = 0U;
+
+    uint32_t ci = i3;
+    uint32_t cq = q3;
+    for (uint8_t s = 0U; s < CIC_STAGES; s++) {
+      uint32_t ti = ci - m_combI[s];
+      uint32_t tq = cq - m_combQ[s];
+      m_combI[s] = ci;
+      m_combQ[s] = cq;
+      ci = ti;
+      cq = tq;
+    }
+
+    int64_t vi = (int64_t(int32_t(ci)) * m_cicScale) >> shift;
+    int64_t vq = (int64_t(int32_t(cq)) * m_cicScale) >> shift;
+
+    outI[n] = q15_t(__SSAT(vi, 16));
+    outQ[n] = q15_t(__SSAT(vq, 16));
+    n++;
+  }
+
+  m_integI[0U] = i0; m_integI[1U] = i1; m_integI[2U] = i2; m_integI[3U] = i3;
+  m_integQ[0U] = q0; m_integQ[1U] = q1; m_integQ[2U] = q2; m_integQ[3U] = q3;
+  m_cicCount = count;
+
+  return n;
+}
+
+void CDecimator::halfBand(q15_t* state, const q15_t* in, uint16_t length, q15_t* out, uint8_t skip)
+{
+  // The input is copied into the state first, so out may be the same buffer as in
+  ::memcpy(state + HALFBAND_TAPS - 1U, in, length * sizeof(q15_t));
+
+  uint16_t n = 0U;
+  for (uint16_t i = skip; i < length; i += 2U) {
+    const q15_t* x = state + i + HALFBAND_MIDDLE;
+
+    q31_t acc = q31_t(x[0]) * HALFBAND_CENTRE;
+    acc += (q31_t(x[-1]) + x[1]) * HALFBAND_COEFFS[0U];
+    acc += (q31_t(x[-3]) + x[3]) * HALFBAND_COEFFS[1U];
+    acc += (q31_t(x[-5]) + x[5]) * HALFBAND_COEFFS[2U];
+    acc += (q31_t(x[-7]) + x[7]) * HALFBAND_COEFFS[3U];
+    acc += (q31_t(x[-9]) + x[9]) * HALFBAND_COEFFS[4U];
+
+    acc = (acc + 0x4000) >> 15;
+    out[n++] = q15_t(__SSAT(acc, 16));
+  }
+
+  ::memmove(state, state + length, (HALFBAND_TAPS - 1U) * sizeof(q15_t));
+}
@@ -0,0 +1,70 @@
+/*
+ *   CIC and half-band decimation chain for wideband SDR sample rates
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(DECIMATOR_H)
+#define  DECIMATOR_H
+
+#include "Globals.h"
+
+// A 4 stage CIC grows a q15 input by 4 * log2(R) bits, R = 16 still fits 32 bits
+const uint8_t  CIC_STAGES         = 4U;
+const uint16_t CIC_MAX_DECIMATION = 16U;
+
+const uint8_t  HALFBAND_MAX_STAGES = 4U;
+const uint16_t HALFBAND_TAPS       = 19U;
+
+// Largest input block handled in one pass, longer blocks are split internally
+const uint16_t DECIMATOR_BLOCK_SIZE = 512U;
+
+class CDecimator {
+public:
+  CDecimator();
+
+  // Chooses the CIC and half-band factors that bring inRate down as far as possible
+  // while staying at or above minOutRate. Returns the output rate.
+  uint32_t setRates(uint32_t inRate, uint32_t minOutRate);
+
+  void reset();
+
+  uint16_t getDecimation() const { return m_cicDecimation << m_halfBands; }
+  uint16_t getCICDecimation() const { return m_cicDecimation; }
+  uint8_t  getHalfBands() const { return m_halfBands; }
+
+  // Decimates interleaved IQ into separate I and Q blocks, returns the number of output samples
+  uint16_t process(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ);
+
+private:
+  uint16_t m_cicDecimation;
+  uint8_t  m_halfBands;
+  int32_t  m_cicScale;
+  uint8_t  m_cicShift;
+  uint16_t m_cicCount;
+  uint32_t m_integI[CIC_STAGES];
+  uint32_t m_integQ[CIC_STAGES];
+  uint32_t m_combI[CIC_STAGES];
+  uint32_t m_combQ[CIC_STAGES];
+  q15_t    m_hbStateI[HALFBAND_MAX_STAGES][HALFBAND_TAPS - 1U + DECIMATOR_BLOCK_SIZE];
+  q15_t    m_hbStateQ[HALFBAND_MAX_STAGES][HALFBAND_TAPS - 1U + DECIMATOR_BLOCK_SIZE];
+  uint8_t  m_hbSkip[HALFBAND_MAX_STAGES];
+
+  uint16_t processBlock(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ);
+  uint16_t cic(const q15_t* iq, uint16_t length, q15_t* outI, q15_t* outQ);
+  void     halfBand(q15_t* state, const q15_t* in, uint16_t length, q15_t* out, uint8_t skip);
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ *   eventfd based wakeup for the modem threads
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Event.h"
+
+#include "Log.h"
+
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+
+CEvent::CEvent() :
+m_fd(-1),
+m_wakeups(0U)
+{
+}
+
+CEvent::~CEvent()
+{
+  if (m_fd != -1)
+    ::close(m_fd);
+}
+
+bool CEvent::open()
+{
+  if (m_fd != -1)
+    return true;
+
+  m_fd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_fd == -1) {
+    LogError("Cannot create an eventfd, errno=%d", errno);
+    return false;
+  }
+
+  return true;
+}
+
+void CEvent::signal()
+{
+  uint64_t one = 1U;
+  ssize_t n = ::write(m_fd, &one, sizeof(one));
+  (void)n;
+}
+
+bool CEvent::wait(int timeoutMs, int fd)
+{
+  struct pollfd fds[2U];
+  fds[0U].fd      = m_fd;
+  fds[0U].events  = POLLIN;
+  fds[0U].revents = 0;
+  fds[1U].fd      = fd;
+  fds[1U].events  = POLLIN;
+  fds[1U].revents = 0;
+
+  struct timespec start;
+  ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+  int n = ::poll(fds, fd == -1 ? 1U : 2U, timeoutMs);
+
+  // With the other end of fd closed poll reports the hangup at once, every time. Wait out the
+  // rest of the timeout on the event alone rather than spinning on it.
+  if (n > 0 && fd != -1 && (fds[0U].revents & POLLIN) == 0 && (fds[1U].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0) {
+    struct timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    int elapsedMs = int((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+
+    if (timeoutMs < 0)
+      n = ::poll(fds, 1U, -1);
+    else
+      n = timeoutMs > elapsedMs ? ::poll(fds, 1U, timeoutMs - elapsedMs) : 0;
+  }
+
+  m_wakeups.fetch_add(1U, std::memory_order_relaxed);
+
+  if (n <= 0 || (fds[0U].revents & POLLIN) == 0)
+    return false;
+
+  // Reading resets the counter, so however many signals arrived release only this wait
+  uint64_t count = 0U;
+  ssize_t r = ::read(m_fd, &count, sizeof(count));
+  (void)r;
+
+  return true;
+}
+
+uint32_t CEvent::getWakeups()
+{
+  return m_wakeups.exchange(0U, std::memory_order_relaxed);
+}
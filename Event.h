@@ -0,0 +1,48 @@
+/*
+ *   eventfd based wakeup for the modem threads
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(EVENT_H)
+#define  EVENT_H
+
+#include <atomic>
+#include <cstdint>
+
+// A wakeup that one thread signals and another blocks on. Signals are not counted, any
+// number of them before a wait releases it once.
+class CEvent {
+public:
+  CEvent();
+  ~CEvent();
+
+  bool open();
+
+  void signal();
+
+  // Blocks until signalled, until fd (when not -1) becomes readable or until the timeout
+  // in milliseconds expires. A hung up fd is ignored. Returns true if signalled.
+  bool wait(int timeoutMs, int fd = -1);
+
+  // The number of times wait has returned since the last call
+  uint32_t getWakeups();
+
+private:
+  int                   m_fd;
+  std::atomic<uint32_t> m_wakeups;
+};
+
+#endif
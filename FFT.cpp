@@ -0,0 +1,99 @@
+/*
+ *   Radix-2 complex FFT for the SoapySX filter banks
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "FFT.h"
+
+#include <cmath>
+#include <utility>
+
+CFFT::CFFT() :
+m_size(0U),
+m_twiddle(),
+m_reverse()
+{
+  setSize(1U);
+}
+
+bool CFFT::setSize(uint16_t size)
+{
+  if (size == 0U || size > FFT_MAX_SIZE || (size & (size - 1U)) != 0U)
+    return false;
+
+  m_size = size;
+
+  uint8_t bits = 0U;
+  while ((1U << bits) < size)
+    bits++;
+
+  for (uint16_t i = 0U; i < size; i++) {
+    uint16_t r = 0U;
+    for (uint8_t b = 0U; b < bits; b++) {
+      if ((i & (1U << b)) != 0U)
+        r |= 1U << (bits - 1U - b);
+    }
+    m_reverse[i] = r;
+  }
+
+  // Forward twiddles, the inverse uses their conjugates
+  for (uint16_t i = 0U; i < size / 2U; i++) {
+    double a = -2.0 * M_PI * double(i) / double(size);
+    m_twiddle[i] = std::complex<float>(float(::cos(a)), float(::sin(a)));
+  }
+
+  return true;
+}
+
+void CFFT::forward(std::complex<float>* data) const
+{
+  transform(data, false);
+}
+
+void CFFT::inverse(std::complex<float>* data) const
+{
+  transform(data, true);
+}
+
+void CFFT::transform(std::complex<float>* data, bool inverse) const
+{
+  for (uint16_t i = 0U; i < m_size; i++) {
+    uint16_t r = m_reverse[i];
+    if (r > i)
+      std::swap(data[i], data[r]);
+  }
+
+  for (uint16_t len = 2U; len <= m_size; len <<= 1) {
+    uint16_t half = len / 2U;
+    uint16_t step = m_size / len;
+
+    for (uint16_t start = 0U; start < m_size; start += len) {
+      for (uint16_t k = 0U; k < half; k++) {
+        std::complex<float> w = m_twiddle[k * step];
+        if (inverse)
+          w = std::conj(w);
+
+        std::complex<float> a = data[start + k];
+        std::complex<float> b = data[start + k + half] * w;
+
+        data[start + k]        = a + b;
+        data[start + k + half] = a - b;
+      }
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ *   Radix-2 complex FFT for the SoapySX filter banks
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FFT_H)
+#define  FFT_H
+
+#include "Globals.h"
+
+#include <complex>
+
+const uint16_t FFT_MAX_SIZE = 64U;
+
+class CFFT {
+public:
+  CFFT();
+
+  // The size must be a power of two no larger than FFT_MAX_SIZE
+  bool setSize(uint16_t size);
+
+  uint16_t getSize() const { return m_size; }
+
+  // In-place transforms, neither is scaled by 1 / N
+  void forward(std::complex<float>* data) const;
+  void inverse(std::complex<float>* data) const;
+
+private:
+  uint16_t            m_size;
+  std::complex<float> m_twiddle[FFT_MAX_SIZE / 2U];
+  uint16_t            m_reverse[FFT_MAX_SIZE];
+
+  void transform(std::complex<float>* data, bool inverse) const;
+};
+
+#endif
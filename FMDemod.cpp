@@ -0,0 +1,138 @@
+/*
+ *   Quadrature FM discriminator for the SoapySX RX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "FMDemod.h"
+
+#include <cmath>
+
+// Angles are in q15 radians
+const int32_t PI_Q15      = 102944;
+const int32_t HALF_PI_Q15 = 51472;
+
+// Polynomial approximation of atan(x) on [0, 1] in q15, max error 1e-5 rad before
+// quantisation (Abramowitz & Stegun 4.4.49)
+const int32_t ATAN_C1 =  32764;
+const int32_t ATAN_C3 = -10823;
+const int32_t ATAN_C5 =   5903;
+const int32_t ATAN_C7 =  -2790;
+const int32_t ATAN_C9 =    683;
+
+CFMDemod::CFMDemod() :
+m_gain(0),
+m_lastI(0),
+m_lastQ(0),
+m_re(),
+m_im()
+{
+  setSampleRate(double(MODEM_SAMPLE_RATE));
+}
+
+void CFMDemod::setSampleRate(double sampleRate)
+{
+  // Phase step per sample in radians is 2 * pi * f / fs
+  m_gain = int32_t(::lround(4096.0 * sampleRate / (2.0 * M_PI * FM_DEMOD_MAX_DEVIATION)));
+}
+
+void CFMDemod::reset()
+{
+  m_lastI = 0;
+  m_lastQ = 0;
+}
+
+uint16_t CFMDemod::process(const q15_t* inI, const q15_t* inQ, q15_t* out, uint16_t length)
+{
+  if (length == 0U)
+    return 0U;
+
+  uint64_t power = 0U;
+  uint16_t count = length;
+
+  while (length > 0U) {
+    uint16_t n = length > FM_DEMOD_BLOCK_SIZE ? FM_DEMOD_BLOCK_SIZE : length;
+
+    // Conjugate product of each sample with its predecessor, its argument is the phase step.
+    // Halving each product keeps the sums inside 32 bits.
+    int32_t prevI = m_lastI;
+    int32_t prevQ = m_lastQ;
+    for (uint16_t i = 0U; i < n; i++) {
+      int32_t re = inI[i];
+      int32_t im = inQ[i];
+
+      m_re[i] = ((re * prevI) >> 1) + ((im * prevQ) >> 1);
+      m_im[i] = ((im * prevI) >> 1) - ((re * prevQ) >> 1);
+
+      power += uint32_t(re * re) + uint32_t(im * im);
+
+      prevI = re;
+      prevQ = im;
+    }
+    m_lastI = q15_t(prevI);
+    m_lastQ = q15_t(prevQ);
+
+    discriminate(out, n);
+
+    inI    += n;
+    inQ    += n;
+    out    += n;
+    length -= n;
+  }
+
+  double rms = ::sqrt(double(power) / double(count));
+
+  return uint16_t(rms > 65535.0 ? 65535.0 : rms);
+}
+
+void CFMDemod::discriminate(q15_t* out, uint16_t length)
+{
+  for (uint16_t i = 0U; i < length; i++) {
+    int32_t re = m_re[i];
+    int32_t im = m_im[i];
+
+    uint32_t ax = uint32_t(re < 0 ? -re : re);
+    uint32_t ay = uint32_t(im < 0 ? -im : im);
+
+    uint32_t mn = ax < ay ? ax : ay;
+    uint32_t mx = ax < ay ? ay : ax;
+
+    // Bring the larger term under 16 bits so the q15 ratio fits a 32 bit division
+    uint32_t shift = mx >= 0x10000U ? 16U - uint32_t(__builtin_clz(mx)) : 0U;
+    uint32_t den   = mx >> shift;
+    den += den == 0U ? 1U : 0U;
+
+    int32_t a = int32_t(((mn >> shift) << 15) / den);
+    int32_t s = (a * a) >> 15;
+
+    int32_t p = ATAN_C9;
+    p = ((p * s) >> 15) + ATAN_C7;
+    p = ((p * s) >> 15) + ATAN_C5;
+    p = ((p * s) >> 15) + ATAN_C3;
+    p = ((p * s) >> 15) + ATAN_C1;
+
+    int32_t r = (p * a) >> 15;
+
+    r = ay > ax ? HALF_PI_Q15 - r : r;
+    r = re < 0  ? PI_Q15 - r      : r;
+    r = im < 0  ? -r              : r;
+
+    int32_t v = int32_t((int64_t(r) * m_gain) >> 12);
+
+    out[i] = q15_t(__SSAT(v, 16));
+  }
+}
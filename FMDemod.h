@@ -0,0 +1,53 @@
+/*
+ *   Quadrature FM discriminator for the SoapySX RX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FMDEMOD_H)
+#define  FMDEMOD_H
+
+#include "Globals.h"
+
+// Frequency deviation in Hz that maps onto q15 full scale
+const float FM_DEMOD_MAX_DEVIATION = 5000.0F;
+
+// Largest block handled in one pass, longer blocks are split internally
+const uint16_t FM_DEMOD_BLOCK_SIZE = 512U;
+
+class CFMDemod {
+public:
+  CFMDemod();
+
+  void setSampleRate(double sampleRate);
+
+  void reset();
+
+  // Converts a block of q15 IQ, held in separate I and Q blocks, into baseband proportional
+  // to the instantaneous frequency, one output per input sample. Returns the RMS signal
+  // magnitude of the block for RSSI.
+  uint16_t process(const q15_t* inI, const q15_t* inQ, q15_t* out, uint16_t length);
+
+private:
+  int32_t  m_gain;                         // q12
+  q15_t    m_lastI;
+  q15_t    m_lastQ;
+  int32_t  m_re[FM_DEMOD_BLOCK_SIZE];
+  int32_t  m_im[FM_DEMOD_BLOCK_SIZE];
+
+  void discriminate(q15_t* out, uint16_t length);
+};
+
+#endif
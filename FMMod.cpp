@@ -0,0 +1,109 @@
+/*
+ *   NCO based FM modulator for the SoapySX TX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "FMMod.h"
+
+#include <cmath>
+
+// One full turn of the oscillator plus a guard entry for the interpolation, cos in the
+// real part and sin in the imaginary part
+static std::complex<float> SINCOS_TABLE[FM_MOD_TABLE_SIZE + 1U];
+static bool                SINCOS_TABLE_INIT = false;
+
+CFMMod::CFMMod() :
+m_sampleRate(double(MODEM_SAMPLE_RATE)),
+m_deviation(FM_MOD_MAX_DEVIATION),
+m_sensitivity(0),
+m_phase(0U),
+m_phases()
+{
+  if (!SINCOS_TABLE_INIT) {
+    for (uint16_t i = 0U; i <= FM_MOD_TABLE_SIZE; i++) {
+      double angle = 2.0 * M_PI * double(i) / double(FM_MOD_TABLE_SIZE);
+      SINCOS_TABLE[i] = std::complex<float>(float(std::cos(angle)), float(std::sin(angle)));
+    }
+
+    SINCOS_TABLE_INIT = true;
+  }
+
+  calculateSensitivity();
+}
+
+void CFMMod::setSampleRate(double sampleRate)
+{
+  m_sampleRate = sampleRate;
+
+  calculateSensitivity();
+}
+
+void CFMMod::setDeviation(float deviation)
+{
+  m_deviation = deviation;
+
+  calculateSensitivity();
+}
+
+void CFMMod::reset()
+{
+  m_phase = 0U;
+}
+
+void CFMMod::calculateSensitivity()
+{
+  // A full scale sample of 32768 must advance the 2^32 phase accumulator by 2^32 * dev / fs
+  m_sensitivity = int32_t(::lround(double(m_deviation) * 131072.0 / m_sampleRate));
+}
+
+void CFMMod::process(const q15_t* in, std::complex<float>* out, uint16_t length)
+{
+  while (length > 0U) {
+    uint16_t n = length > FM_MOD_BLOCK_SIZE ? FM_MOD_BLOCK_SIZE : length;
+
+    processBlock(in, out, n);
+
+    in     += n;
+    out    += n;
+    length -= n;
+  }
+}
+
+void CFMMod::processBlock(const q15_t* in, std::complex<float>* out, uint16_t length)
+{
+  // The phase accumulation is a running sum, keep it apart from the table lookups
+  uint32_t phase = m_phase;
+  for (uint16_t i = 0U; i < length; i++) {
+    phase += uint32_t(int32_t(in[i]) * m_sensitivity);
+    m_phases[i] = phase;
+  }
+  m_phase = phase;
+
+  // Linear interpolation between table entries using the next 16 bits of phase
+  const uint8_t SHIFT = 32U - FM_MOD_TABLE_BITS;
+  const float   SCALE = 1.0F / 65536.0F;
+  for (uint16_t i = 0U; i < length; i++) {
+    uint32_t idx  = m_phases[i] >> SHIFT;
+    float    frac = float((m_phases[i] >> (SHIFT - 16U)) & 0xFFFFU) * SCALE;
+
+    std::complex<float> a = SINCOS_TABLE[idx];
+    std::complex<float> b = SINCOS_TABLE[idx + 1U];
+
+    out[i] = std::complex<float>(a.real() + (b.real() - a.real()) * frac, a.imag() + (b.imag() - a.imag()) * frac);
+  }
+}
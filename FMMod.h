@@ -0,0 +1,61 @@
+/*
+ *   NCO based FM modulator for the SoapySX TX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FMMOD_H)
+#define  FMMOD_H
+
+#include "Globals.h"
+
+#include <complex>
+
+// Default frequency deviation in Hz produced by a q15 full scale sample, the per mode
+// peak deviation is this scaled by the mode's TX level
+const float FM_MOD_MAX_DEVIATION = 5000.0F;
+
+// The top FM_MOD_TABLE_BITS of the phase accumulator index the sin/cos table, the
+// following bits interpolate between entries
+const uint8_t  FM_MOD_TABLE_BITS = 10U;
+const uint16_t FM_MOD_TABLE_SIZE = 1U << FM_MOD_TABLE_BITS;
+
+// Largest block handled in one pass, longer blocks are split internally
+const uint16_t FM_MOD_BLOCK_SIZE = 512U;
+
+class CFMMod {
+public:
+  CFMMod();
+
+  void setSampleRate(double sampleRate);
+  void setDeviation(float deviation);
+
+  void reset();
+
+  // Converts a block of baseband into unit magnitude IQ, one output per input sample
+  void process(const q15_t* in, std::complex<float>* out, uint16_t length);
+
+private:
+  double   m_sampleRate;
+  float    m_deviation;
+  int32_t  m_sensitivity;
+  uint32_t m_phase;
+  uint32_t m_phases[FM_MOD_BLOCK_SIZE];
+
+  void calculateSensitivity();
+  void processBlock(const q15_t* in, std::complex<float>* out, uint16_t length);
+};
+
+#endif
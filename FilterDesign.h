@@ -0,0 +1,279 @@
+/*
+ *   Compile time design of the modem filter coefficient tables
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FILTERDESIGN_H)
+#define  FILTERDESIGN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Everything here is constexpr, so a table declared as
+ *
+ *   static constexpr auto TAPS = rxTaps<42U>(designRRC<8U, 5U>(0.2), 32768.0);
+ *
+ * is computed by the compiler and lands in .rodata. The designs follow the MATLAB functions
+ * the old hand pasted tables came from, rcosdesign and gaussfir, and reproduce those tables
+ * exactly for the same parameters.
+ */
+
+constexpr double FD_PI  = 3.14159265358979323846;
+constexpr double FD_LN2 = 0.69314718055994530942;
+
+// The <cmath> functions are not constexpr, these are accurate to a few ulp over the ranges the
+// designs use
+constexpr double fdAbs(double x)
+{
+  return x < 0.0 ? -x : x;
+}
+
+constexpr double fdRound(double x)
+{
+  // Halves away from zero, as MATLAB round() does
+  return x < 0.0 ? -double(int64_t(-x + 0.5)) : double(int64_t(x + 0.5));
+}
+
+constexpr double fdSqrt(double x)
+{
+  if (x <= 0.0)
+    return 0.0;
+
+  // Newton from above decreases monotonically until it reaches the root
+  double r = x > 1.0 ? x : 1.0;
+  for (;;) {
+    double n = 0.5 * (r + x / r);
+    if (n >= r)
+      return r;
+    r = n;
+  }
+}
+
+constexpr double fdSin(double x)
+{
+  // Reduce to [-pi, pi], then fold onto [-pi/2, pi/2]
+  double k = fdRound(x / (2.0 * FD_PI));
+  x -= k * 2.0 * FD_PI;
+  if (x > FD_PI / 2.0)
+    x = FD_PI - x;
+  else if (x < -FD_PI / 2.0)
+    x = -FD_PI - x;
+
+  double term = x;
+  double sum  = x;
+  for (int n = 1; n < 20; n++) {
+    term *= -x * x / double((2 * n) * (2 * n + 1));
+    sum  += term;
+  }
+
+  return sum;
+}
+
+constexpr double fdCos(double x)
+{
+  return fdSin(x + FD_PI / 2.0);
+}
+
+constexpr double fdExp(double x)
+{
+  if (x < -700.0)
+    return 0.0;
+
+  // exp(x) = 2^n * exp(r) with |r| <= ln(2) / 2
+  double n = fdRound(x / FD_LN2);
+  double r = x - n * FD_LN2;
+
+  double term = 1.0;
+  double sum  = 1.0;
+  for (int i = 1; i < 25; i++) {
+    term *= r / double(i);
+    sum  += term;
+  }
+
+  for (; n > 0.0; n -= 1.0)
+    sum *= 2.0;
+  for (; n < 0.0; n += 1.0)
+    sum *= 0.5;
+
+  return sum;
+}
+
+// Root raised cosine over SPAN symbols at SPS samples per symbol with unit energy, as
+// rcosdesign(beta, SPAN, SPS, 'sqrt')
+template <uint16_t SPAN, uint16_t SPS>
+constexpr std::array<double, SPAN * SPS + 1U> designRRC(double beta)
+{
+  std::array<double, SPAN * SPS + 1U> b{};
+
+  double energy = 0.0;
+  for (size_t i = 0U; i < b.size(); i++) {
+    double t = (double(i) - double(SPAN * SPS) / 2.0) / double(SPS);
+
+    double v = 0.0;
+    if (t == 0.0) {
+      v = -1.0 / (FD_PI * SPS) * (FD_PI * (beta - 1.0) - 4.0 * beta);
+    } else if (fdAbs(fdAbs(4.0 * beta * t) - 1.0) < 1.0E-10) {
+      v = 1.0 / (2.0 * FD_PI * SPS) * (FD_PI * (beta + 1.0) * fdSin(FD_PI * (beta + 1.0) / (4.0 * beta)) -
+                                       4.0 * beta * fdSin(FD_PI * (beta - 1.0) / (4.0 * beta)) +
+                                       FD_PI * (beta - 1.0) * fdCos(FD_PI * (beta - 1.0) / (4.0 * beta)));
+    } else {
+      v = -4.0 * beta / SPS * (fdCos((1.0 + beta) * FD_PI * t) + fdSin((1.0 - beta) * FD_PI * t) / (4.0 * beta * t)) /
+          (FD_PI * ((4.0 * beta * t) * (4.0 * beta * t) - 1.0));
+    }
+
+    b[i]    = v;
+    energy += v * v;
+  }
+
+  double norm = fdSqrt(energy);
+  for (size_t i = 0U; i < b.size(); i++)
+    b[i] /= norm;
+
+  return b;
+}
+
+// Raised cosine over SPAN symbols at SPS samples per symbol with unit energy, as
+// rcosdesign(beta, SPAN, SPS, 'normal')
+template <uint16_t SPAN, uint16_t SPS>
+constexpr std::array<double, SPAN * SPS + 1U> designRC(double beta)
+{
+  std::array<double, SPAN * SPS + 1U> b{};
+
+  double energy = 0.0;
+  for (size_t i = 0U; i < b.size(); i++) {
+    double t = (double(i) - double(SPAN * SPS) / 2.0) / double(SPS);
+
+    double v = 0.0;
+    double den = 1.0 - (2.0 * beta * t) * (2.0 * beta * t);
+    if (fdAbs(den) < 1.0E-10)
+      v = beta / (2.0 * SPS) * fdSin(FD_PI / (2.0 * beta));
+    else if (t == 0.0)
+      v = 1.0 / SPS;
+    else
+      v = fdSin(FD_PI * t) / (FD_PI * t) * fdCos(FD_PI * beta * t) / den / SPS;
+
+    b[i]    = v;
+    energy += v * v;
+  }
+
+  double norm = fdSqrt(energy);
+  for (size_t i = 0U; i < b.size(); i++)
+    b[i] /= norm;
+
+  return b;
+}
+
+// Gaussian with bandwidth-time product bt over SPAN symbols either side of the centre at SPS
+// samples per symbol with unit sum, as gaussfir(bt, SPAN, SPS)
+template <uint16_t SPAN, uint16_t SPS>
+constexpr std::array<double, 2U * SPAN * SPS + 1U> designGaussian(double bt)
+{
+  std::array<double, 2U * SPAN * SPS + 1U> h{};
+
+  double alpha = fdSqrt(FD_LN2 / 2.0) / bt;
+
+  double sum = 0.0;
+  for (size_t i = 0U; i < h.size(); i++) {
+    double t = (double(i) - double(SPAN * SPS)) / double(SPS);
+    double x = t * FD_PI / alpha;
+
+    h[i] = fdSqrt(FD_PI) / alpha * fdExp(-x * x);
+    sum += h[i];
+  }
+
+  for (size_t i = 0U; i < h.size(); i++)
+    h[i] /= sum;
+
+  return h;
+}
+
+template <size_t N>
+constexpr std::array<double, N> normalisePeak(const std::array<double, N>& taps)
+{
+  double peak = 0.0;
+  for (size_t i = 0U; i < N; i++) {
+    if (fdAbs(taps[i]) > peak)
+      peak = fdAbs(taps[i]);
+  }
+
+  std::array<double, N> out{};
+  for (size_t i = 0U; i < N; i++)
+    out[i] = taps[i] / peak;
+
+  return out;
+}
+
+// Taps for arm_fir_fast_q15, OUT of them taken about the centre of the design. An even OUT one
+// longer than the design adds a zero tap at the end, a shorter OUT trims the tails.
+template <size_t OUT, size_t N>
+constexpr std::array<int16_t, OUT> rxTaps(const std::array<double, N>& taps, double gain)
+{
+  std::array<int16_t, OUT> out{};
+
+  long offset = (long(N) - long(OUT) + 1L) / 2L;
+  for (size_t i = 0U; i < OUT; i++) {
+    long j = long(i) + offset;
+    if (j >= 0L && j < long(N))
+      out[i] = int16_t(fdRound(taps[size_t(j)] * gain));
+  }
+
+  return out;
+}
+
+// Taps for arm_fir_interpolate_q15, OUT of them with the end of the design at the end. OUT is
+// a whole number of phases, longer than the design pads the front with zeros and shorter drops
+// leading taps.
+template <size_t OUT, size_t N>
+constexpr std::array<int16_t, OUT> txTaps(const std::array<double, N>& taps, double gain)
+{
+  std::array<int16_t, OUT> out{};
+
+  long offset = long(N) - long(OUT);
+  for (size_t i = 0U; i < OUT; i++) {
+    long j = long(i) + offset;
+    if (j >= 0L)
+      out[i] = int16_t(fdRound(taps[size_t(j)] * gain));
+  }
+
+  return out;
+}
+
+// The q15 cascade of two filters as one, rounded back to q15, with OUT - (N1 + N2 - 1) zero
+// taps in front so the delay of the cascade is kept
+template <size_t OUT, size_t N1, size_t N2>
+constexpr std::array<int16_t, OUT> cascadeTaps(const std::array<int16_t, N1>& a, const std::array<int16_t, N2>& b)
+{
+  static_assert(OUT >= N1 + N2 - 1U, "cascade needs N1 + N2 - 1 taps");
+
+  std::array<int16_t, OUT> out{};
+
+  const size_t lead = OUT - (N1 + N2 - 1U);
+  for (size_t n = 0U; n < N1 + N2 - 1U; n++) {
+    int64_t sum = 0;
+    for (size_t i = 0U; i < N1; i++) {
+      if (n >= i && n - i < N2)
+        sum += int64_t(a[i]) * int64_t(b[n - i]);
+    }
+
+    out[lead + n] = int16_t((sum + 16384) >> 15);
+  }
+
+  return out;
+}
+
+#endif
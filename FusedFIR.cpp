@@ -0,0 +1,96 @@
+/*
+ *   Several FIR filters run over shared input windows in one pass
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "FusedFIR.h"
+
+#include <cstring>
+
+// Every window holds FUSED_FIR_MAX_TAPS - 1 samples of history, a shorter filter starts its
+// taps that much further in
+const uint16_t HISTORY_LEN = FUSED_FIR_MAX_TAPS - 1U;
+
+CFusedFIR::CFusedFIR() :
+m_coeffs(),
+m_taps(),
+m_input(),
+m_filters(0U),
+m_inputs(0U),
+m_window()
+{
+}
+
+bool CFusedFIR::setFilter(uint8_t n, uint8_t input, const q15_t* coeffs, uint16_t numTaps)
+{
+  if (n >= FUSED_FIR_MAX_FILTERS || input >= FUSED_FIR_MAX_INPUTS || coeffs == NULL)
+    return false;
+
+  if (numTaps == 0U || numTaps > FUSED_FIR_MAX_TAPS || (numTaps & 1U) != 0U)
+    return false;
+
+  m_coeffs[n] = coeffs;
+  m_taps[n]   = numTaps;
+  m_input[n]  = input;
+
+  if (n >= m_filters)
+    m_filters = n + 1U;
+  if (input >= m_inputs)
+    m_inputs = input + 1U;
+
+  return true;
+}
+
+void CFusedFIR::reset()
+{
+  ::memset(m_window, 0x00U, sizeof(m_window));
+}
+
+void CFusedFIR::process(const q15_t* const* in, uint16_t length, q15_t* const* out)
+{
+  uint16_t done = 0U;
+
+  while (done < length) {
+    uint16_t n = length - done;
+    if (n > FUSED_FIR_BLOCK_SIZE)
+      n = FUSED_FIR_BLOCK_SIZE;
+
+    for (uint8_t i = 0U; i < m_inputs; i++)
+      ::memcpy(m_window[i] + HISTORY_LEN, in[i] + done, n * sizeof(q15_t));
+
+    // Every filter takes a chunk while that part of the windows is still in cache
+    for (uint16_t pos = 0U; pos < n; pos += FUSED_FIR_CHUNK_SIZE) {
+      uint16_t count = n - pos;
+      if (count > FUSED_FIR_CHUNK_SIZE)
+        count = FUSED_FIR_CHUNK_SIZE;
+
+      for (uint8_t f = 0U; f < m_filters; f++) {
+        if (out[f] == NULL || m_coeffs[f] == NULL)
+          continue;
+
+        const q15_t* window = m_window[m_input[f]] + HISTORY_LEN - (m_taps[f] - 1U) + pos;
+        ::arm_fir_window_q15(m_coeffs[f], m_taps[f], window, out[f] + done + pos, count);
+      }
+    }
+
+    for (uint8_t i = 0U; i < m_inputs; i++)
+      ::memmove(m_window[i], m_window[i] + n, HISTORY_LEN * sizeof(q15_t));
+
+    done += n;
+  }
+}
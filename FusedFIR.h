@@ -0,0 +1,57 @@
+/*
+ *   Several FIR filters run over shared input windows in one pass
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FUSEDFIR_H)
+#define  FUSEDFIR_H
+
+#include "Globals.h"
+
+const uint8_t  FUSED_FIR_MAX_FILTERS = 8U;
+const uint8_t  FUSED_FIR_MAX_INPUTS  = 2U;
+const uint16_t FUSED_FIR_MAX_TAPS    = 114U;
+
+// Largest block handled in one pass, longer blocks are split internally
+const uint16_t FUSED_FIR_BLOCK_SIZE  = 480U;
+
+// Outputs produced by every filter before moving on, small enough for the window to stay in L1
+const uint16_t FUSED_FIR_CHUNK_SIZE  = 64U;
+
+class CFusedFIR {
+public:
+  CFusedFIR();
+
+  // Filter n reads the given input, the taps are those of arm_fir_fast_q15 and their count is even
+  bool setFilter(uint8_t n, uint8_t input, const q15_t* coeffs, uint16_t numTaps);
+
+  void reset();
+
+  // Filters one block of every input. Each input keeps a single history window that all of its
+  // filters share, so the history stays current for filters that are skipped. A NULL entry in out
+  // skips that filter for this block.
+  void process(const q15_t* const* in, uint16_t length, q15_t* const* out);
+
+private:
+  const q15_t* m_coeffs[FUSED_FIR_MAX_FILTERS];
+  uint16_t     m_taps[FUSED_FIR_MAX_FILTERS];
+  uint8_t      m_input[FUSED_FIR_MAX_FILTERS];
+  uint8_t      m_filters;
+  uint8_t      m_inputs;
+  q15_t        m_window[FUSED_FIR_MAX_INPUTS][FUSED_FIR_MAX_TAPS - 1U + FUSED_FIR_BLOCK_SIZE];
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ *   Table driven GMSK modulator for the D-Star transmitter
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(GMSKTX_H)
+#define  GMSKTX_H
+
+#include "Config.h"
+#include "Globals.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * The Gaussian filter spans three bits, so each bit's output samples are set by that bit and the
+ * two before it. Those samples are tabled whole, already rounded and saturated the way
+ * arm_fir_interpolate_q15 does, and a bit costs one table copy. Each bit of the history is kept
+ * as a two bit code with 0 for silence, so the first bits after power on also match a filter
+ * starting from a zeroed state.
+ */
+const uint16_t TX_GMSK_HISTORY_BITS = 3U;
+const uint16_t TX_GMSK_ENTRIES      = 1U << (2U * TX_GMSK_HISTORY_BITS);
+
+// Bytes modulated per io.write by the transmitter
+const uint16_t TX_GMSK_BLOCK_BYTES = 12U;
+
+// The table for taps laid out for arm_fir_interpolate_q15 at SPS samples per bit, with level0 and
+// level1 the levels sent for 0 and 1 bits
+template <uint16_t SPS, size_t N>
+constexpr std::array<q15_t, TX_GMSK_ENTRIES * SPS> gmskTable(const std::array<int16_t, N>& taps, q15_t level0, q15_t level1)
+{
+  static_assert((N % SPS) == 0U && (N / SPS) <= TX_GMSK_HISTORY_BITS, "the filter must be whole phases of at most three bits");
+
+  const size_t phaseLen = N / SPS;
+
+  // By code, silence, a 0 bit and a 1 bit, code 3 is unused
+  const q31_t level[4U] = {0, level0, level1, 0};
+
+  std::array<q15_t, TX_GMSK_ENTRIES * SPS> table{};
+
+  for (size_t entry = 0U; entry < TX_GMSK_ENTRIES; entry++) {
+    for (size_t phase = 0U; phase < SPS; phase++) {
+      q31_t sum = 0;
+
+      // Bit age of an entry is the one age bits before the newest
+      for (size_t age = 0U; age < phaseLen; age++)
+        sum += level[(entry >> (2U * age)) & 0x03U] * taps[(SPS - 1U - phase) + SPS * (phaseLen - 1U - age)];
+
+      sum >>= 15;
+      table[entry * SPS + phase] = q15_t(__SSAT(sum, 16));
+    }
+  }
+
+  return table;
+}
+
+template <uint16_t SPS>
+class CGMSKTX {
+public:
+  static constexpr uint16_t BYTE_SAMPLES = 8U * SPS;
+
+  // Bytes into a burst before its samples no longer depend on what was sent before it
+  static constexpr uint16_t SETTLE_BYTES = 1U;
+
+  CGMSKTX(const q15_t* table) :
+  m_table(table),
+  m_history(0U)
+  {
+  }
+
+  // The whole bytes that fit in space samples, as many as a byte at a time writer that stops
+  // with a byte or less of space left would write
+  static uint16_t getBytes(uint16_t space)
+  {
+    return space > 0U ? (space - 1U) / (8U * SPS) : 0U;
+  }
+
+  // The leading bytes of data that are c, when the last byte sent was c too. Each of those gives
+  // the same samples as the one before.
+  uint16_t getRun(uint8_t c, const uint8_t* data, uint16_t length) const
+  {
+    uint16_t history = m_history;
+    shiftByte(history, c);
+    if (history != m_history)
+      return 0U;
+
+    uint16_t n = 0U;
+    while (n < length && data[n] == c)
+      n++;
+
+    return n;
+  }
+
+  // Moves the history on as if the bytes had been modulated
+  void advance(const uint8_t* data, uint16_t length)
+  {
+    for (uint16_t i = 0U; i < length; i++)
+      shiftByte(m_history, data[i]);
+  }
+
+  // Eight bits per byte, least significant first as D-Star sends them, giving 8 * SPS samples
+  // per byte
+  void modulate(const uint8_t* data, uint16_t length, q15_t* out)
+  {
+    for (uint16_t i = 0U; i < length; i++) {
+      uint8_t c = data[i];
+
+      for (uint8_t j = 0U; j < 8U; j++, c >>= 1) {
+        m_history = next(m_history, c);
+
+        ::memcpy(out, m_table + m_history * SPS, SPS * sizeof(q15_t));
+        out += SPS;
+      }
+    }
+  }
+
+private:
+  const q15_t* m_table;
+  uint16_t     m_history;                  // Newest bit in the low bits
+
+  // The history after the least significant bit of c
+  static uint16_t next(uint16_t history, uint8_t c)
+  {
+    return ((history << 2) | (1U + (c & 0x01U))) & (TX_GMSK_ENTRIES - 1U);
+  }
+
+  static void shiftByte(uint16_t& history, uint8_t c)
+  {
+    for (uint8_t j = 0U; j < 8U; j++, c >>= 1)
+      history = next(history, c);
+  }
+};
+
+#endif
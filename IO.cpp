@@ -21,40 +21,15 @@
 #include "Config.h"
 #include "Globals.h"
 #include "IO.h"
+#include "RXFilters.h"
 
 #include "Log.h"
 
 #include <cstdlib>
+#include <cstring>
 
-// Generated using [b, a] = butter(1, 0.001) in MATLAB
-static q31_t   DC_FILTER[] = {3367972, 0, 3367972, 0, 2140747704, 0}; // {b0, 0, b1, b2, -a1, -a2}
-const uint32_t DC_FILTER_STAGES = 1U; // One Biquad stage
-
-// Generated using rcosdesign(0.2, 8, 5, 'sqrt') in MATLAB
-static q15_t RRC_0_2_FILTER[] = {401, 104, -340, -731, -847, -553, 112, 909, 1472, 1450, 683, -675, -2144, -3040, -2706, -770, 2667, 6995,
-                                 11237, 14331, 15464, 14331, 11237, 6995, 2667, -770, -2706, -3040, -2144, -675, 683, 1450, 1472, 909, 112,
-                                 -553, -847, -731, -340, 104, 401, 0};
-const uint16_t RRC_0_2_FILTER_LEN = 42U;
-
-// Generated using rcosdesign(0.2, 8, 10, 'sqrt') in MATLAB
-static q15_t NXDN_0_2_FILTER[] = {284, 198, 73, -78, -240, -393, -517, -590, -599, -533, -391, -181, 79, 364, 643, 880, 1041, 1097, 1026, 819,
-                                  483, 39, -477, -1016, -1516, -1915, -2150, -2164, -1914, -1375, -545, 557, 1886, 3376, 4946, 6502, 7946, 9184,
-                                  10134, 10731, 10935, 10731, 10134, 9184, 7946, 6502, 4946, 3376, 1886, 557, -545, -1375, -1914, -2164, -2150,
-                                  -1915, -1516, -1016, -477, 39, 483, 819, 1026, 1097, 1041, 880, 643, 364, 79, -181, -391, -533, -599, -590,
-                                  -517, -393, -240, -78, 73, 198, 284, 0};
-const uint16_t NXDN_0_2_FILTER_LEN = 82U;
-
-static q15_t NXDN_ISINC_FILTER[] = {790, -1085, -1073, -553, 747, 2341, 3156, 2152, -893, -4915, -7834, -7536, -3102, 4441, 12354, 17394, 17394,
-                                   12354, 4441, -3102, -7536, -7834, -4915, -893, 2152, 3156, 2341, 747, -553, -1073, -1085, 790};
-const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
-
-// Generated using gaussfir(0.5, 4, 5) in MATLAB
-static q15_t   GAUSSIAN_0_5_FILTER[] = {8, 104, 760, 3158, 7421, 9866, 7421, 3158, 760, 104, 8, 0};
-const uint16_t GAUSSIAN_0_5_FILTER_LEN = 12U;
-
-// One symbol boxcar filter
-static q15_t   BOXCAR_FILTER[] = {12000, 12000, 12000, 12000, 12000, 0};
-const uint16_t BOXCAR_FILTER_LEN = 6U;
+// Samples levelled on the stack per TX ring write
+const uint16_t TX_WRITE_CHUNK = 32U;
 
 const uint16_t DC_OFFSET = 2048U;
 
@@ -63,19 +38,23 @@ m_started(false),
 m_thread(),
 m_rxBuffer(RX_RINGBUFFER_SIZE),
 m_txBuffer(TX_RINGBUFFER_SIZE),
-m_rssiBuffer(RX_RINGBUFFER_SIZE),
+m_mainProfile("MAIN"),
+m_txProfile("TX"),
+m_rxProfile("RX"),
+m_dspEvent(),
+m_txEvent(),
+m_txWaiting(false),
+m_rxWakeups(0U),
+m_wakeupTime(0U),
 m_dcFilter(),
 m_dcState(),
-m_rrcFilter(),
-m_gaussianFilter(),
-m_boxcarFilter(),
-m_nxdnFilter(),
-m_nxdnISincFilter(),
-m_rrcState(),
-m_gaussianState(),
-m_boxcarState(),
-m_nxdnState(),
-m_nxdnISincState(),
+m_rxFilters(),
+m_rrcDecimator(),
+m_p25Decimator(),
+m_nxdnDecimator(),
+m_rrcTiming(),
+m_p25Timing(),
+m_nxdnTiming(),
 m_pttInvert(false),
 m_rxLevel(128 * 128),
 m_cwIdTXLevel(128 * 128),
@@ -84,6 +63,7 @@ m_dmrTXLevel(128 * 128),
 m_ysfTXLevel(128 * 128),
 m_p25TXLevel(128 * 128),
 m_nxdnTXLevel(128 * 128),
+m_levelSerial(1U),
 m_rxDCOffset(DC_OFFSET),
 m_txDCOffset(DC_OFFSET),
 m_ledCount(0U),
@@ -97,18 +77,34 @@ m_sdrSampleRate(125000.0),
 m_centerFrequency(446000000.0),
 m_rxGainDb(30.0),
 m_txGainDb(0.0),
-m_rxResampleRatio(1.0),
-m_txResampleRatio(1.0),
-m_rxFrac(0.0),
-m_txFrac(0.0),
-m_prevRxSample(0),
-m_prevTxSample(0)
+m_txDeviation(FM_MOD_MAX_DEVIATION),
+m_channels(1U),
+m_channel(0),
+m_channelizer(),
+m_rxChannel(),
+m_rxChannels(),
+m_decimator(),
+m_rxReadSize(SDR_BLOCK_SIZE),
+m_rxFormat(IQ_CF32),
+m_rxSampleBytes(8U),
+m_rxIQ(),
+m_rxIQ15(),
+m_rxIQ8(),
+m_rxI(),
+m_rxQ(),
+m_fmDemod(),
+m_rxDemod(),
+m_fmMod(),
+m_txBaseband(),
+m_txIQ(),
+m_synthesizer(),
+m_txWide(),
+m_txChannels(),
+m_rxResampler(),
+m_txResampler(),
+m_rxModem(),
+m_txModem()
 {
-  ::memset(m_rrcState,      0x00U,  70U * sizeof(q15_t));
-  ::memset(m_gaussianState, 0x00U,  40U * sizeof(q15_t));
-  ::memset(m_boxcarState,   0x00U,  30U * sizeof(q15_t));
-  ::memset(m_nxdnState,     0x00U, 110U * sizeof(q15_t));
-  ::memset(m_nxdnISincState, 0x00U, 60U * sizeof(q15_t));
   ::memset(m_dcState,       0x00U,   4U * sizeof(q31_t));
 
   m_dcFilter.numStages = DC_FILTER_STAGES;
@@ -116,25 +112,24 @@ m_prevTxSample(0)
   m_dcFilter.pCoeffs   = DC_FILTER;
   m_dcFilter.postShift = 0;
 
-  m_rrcFilter.numTaps = RRC_0_2_FILTER_LEN;
-  m_rrcFilter.pState  = m_rrcState;
-  m_rrcFilter.pCoeffs = RRC_0_2_FILTER;
-
-  m_gaussianFilter.numTaps = GAUSSIAN_0_5_FILTER_LEN;
-  m_gaussianFilter.pState  = m_gaussianState;
-  m_gaussianFilter.pCoeffs = GAUSSIAN_0_5_FILTER;
-
-  m_boxcarFilter.numTaps = BOXCAR_FILTER_LEN;
-  m_boxcarFilter.pState  = m_boxcarState;
-  m_boxcarFilter.pCoeffs = BOXCAR_FILTER;
-  
-  m_nxdnFilter.numTaps = NXDN_0_2_FILTER_LEN;
-  m_nxdnFilter.pState  = m_nxdnState;
-  m_nxdnFilter.pCoeffs = NXDN_0_2_FILTER;
-  
-  m_nxdnISincFilter.numTaps = NXDN_ISINC_FILTER_LEN;
-  m_nxdnISincFilter.pState  = m_nxdnISincState;
-  m_nxdnISincFilter.pCoeffs = NXDN_ISINC_FILTER;
+  // DMR takes the RRC before the DC blocker, as do the idle DMR and YSF receivers, while YSF
+  // itself takes it after
+  m_rxFilters.setFilter(RX_FILTER_GAUSSIAN,     RX_INPUT_DC,  GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN);
+  m_rxFilters.setFilter(RX_FILTER_GAUSSIAN_RAW, RX_INPUT_RAW, GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN);
+  m_rxFilters.setFilter(RX_FILTER_BOXCAR,       RX_INPUT_DC,  BOXCAR_FILTER,                BOXCAR_FILTER_LEN);
+  m_rxFilters.setFilter(RX_FILTER_NXDN,         RX_INPUT_DC,  NXDN_0_2_ISINC_FILTER.data(), NXDN_0_2_ISINC_FILTER_LEN);
+  m_rxFilters.setFilter(RX_FILTER_RRC,          RX_INPUT_RAW, RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN);
+  m_rxFilters.setFilter(RX_FILTER_RRC_DC,       RX_INPUT_DC,  RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN);
+  m_rxFilters.reset();
+
+  // The 4FSK receivers run at their own samples per symbol, see RX_4FSK_SYMBOL_LENGTH
+  m_rrcDecimator.setRatio(SPS_4800, DMR_RX_SYMBOL_LENGTH);
+  m_p25Decimator.setRatio(SPS_4800, P25_RX_SYMBOL_LENGTH);
+  m_nxdnDecimator.setRatio(SPS_2400, NXDN_RX_SYMBOL_LENGTH);
+
+  m_rrcTiming.setSymbolLength(DMR_RX_SYMBOL_LENGTH);
+  m_p25Timing.setSymbolLength(P25_RX_SYMBOL_LENGTH);
+  m_nxdnTiming.setSymbolLength(NXDN_RX_SYMBOL_LENGTH);
 
   initInt();
 
@@ -157,6 +152,36 @@ m_prevTxSample(0)
   if (txGainEnv != nullptr)
     m_txGainDb = ::atof(txGainEnv);
 
+  const char *txDevEnv = std::getenv("SX_TX_DEVIATION_HZ");
+  if (txDevEnv != nullptr)
+    m_txDeviation = float(::atof(txDevEnv));
+
+  const char *directEnv = std::getenv("SX_DIRECT_ACCESS");
+  if (directEnv != nullptr)
+    m_frontend.setDirectAccess(::atoi(directEnv) != 0);
+
+  const char *formatEnv = std::getenv("SX_RX_FORMAT");
+  if (formatEnv != nullptr) {
+    if (::strcmp(formatEnv, "CS16") == 0)
+      m_frontend.setRxFormat(IQ_CS16);
+    else if (::strcmp(formatEnv, "CS8") == 0)
+      m_frontend.setRxFormat(IQ_CS8);
+    else if (::strcmp(formatEnv, "CF32") == 0)
+      m_frontend.setRxFormat(IQ_CF32);
+  }
+
+  const char *channelsEnv = std::getenv("SX_CHANNELS");
+  if (channelsEnv != nullptr)
+    m_channels = uint16_t(::atoi(channelsEnv));
+
+  const char *channelEnv = std::getenv("SX_CHANNEL");
+  if (channelEnv != nullptr)
+    m_channel = ::atoi(channelEnv);
+
+  m_mainProfile.load();
+  m_txProfile.load();
+  m_rxProfile.load();
+
   m_frontend.setFrequency(m_centerFrequency);
   m_frontend.setSampleRate(m_sdrSampleRate);
   m_frontend.setRxGain(m_rxGainDb);
@@ -310,31 +335,30 @@ void CIO::process()
   //m_lockout = getCOSInt();
 #endif
 
-    ::pthread_mutex_lock(&m_TXlock);
   // Switch off the transmitter if needed
   if (m_txBuffer.getData() == 0U && m_tx) {
     m_tx = false;
     setPTTInt(m_pttInvert ? true : false);
   }
-  ::pthread_mutex_unlock(&m_TXlock);
 
-  ::pthread_mutex_lock(&m_RXlock);
-  u_int16_t block_size = m_rxBuffer.getData();
-  ::pthread_mutex_unlock(&m_RXlock);
-  
-  if (block_size >= RX_BLOCK_SIZE) {
-    uint16_t num_blocks = block_size / RX_BLOCK_SIZE;
-    for(uint16_t block_no = 0;block_no < num_blocks; block_no++)
-    {
+  // Take whatever has arrived in blocks of up to RX_BLOCK_SIZE, so the filters and decoders
+  // run once per block rather than once per pair of samples
+  for (;;) {
+    uint16_t length = m_rxBuffer.getData();
+    if (length == 0U)
+      break;
+    if (length > RX_BLOCK_SIZE)
+      length = RX_BLOCK_SIZE;
+
     q15_t    samples[RX_BLOCK_SIZE];
     uint8_t  control[RX_BLOCK_SIZE];
     uint16_t rssi[RX_BLOCK_SIZE];
 
-    ::pthread_mutex_lock(&m_RXlock);
-    for (uint16_t i = 0U; i < RX_BLOCK_SIZE; i++) {
-      uint16_t sample;
-      m_rxBuffer.get(sample, control[i]);
-      m_rssiBuffer.get(rssi[i]);
+    uint16_t raw[RX_BLOCK_SIZE];
+    m_rxBuffer.get(raw, control, rssi, length);
+
+    for (uint16_t i = 0U; i < length; i++) {
+      uint16_t sample = raw[i];
 
       // Detect ADC overflow
       if (m_detect && (sample == 0U || sample == 4095U))
@@ -344,7 +368,6 @@ void CIO::process()
       q31_t res2 = res1 * m_rxLevel;
       samples[i] = q15_t(__SSAT((res2 >> 15), 16));
     }
-    ::pthread_mutex_unlock(&m_RXlock);
 
     //if (m_lockout)
     //  return;
@@ -352,144 +375,169 @@ void CIO::process()
 
 #if defined(USE_DCBLOCKER)
     q31_t q31Samples[RX_BLOCK_SIZE];
-    ::arm_q15_to_q31(samples, q31Samples, RX_BLOCK_SIZE);
+    ::arm_q15_to_q31(samples, q31Samples, length);
 
     q31_t dcValues[RX_BLOCK_SIZE];
-    ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, RX_BLOCK_SIZE);
+    ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, length);
 
-    q31_t dcLevel = 0;
-   for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
+    // Summed in 64 bits, a full block of q31 values would wrap a 32 bit accumulator
+    q63_t dcLevel = 0;
+    for (uint16_t i = 0U; i < length; i++)
       dcLevel += dcValues[i];
-    dcLevel /= RX_BLOCK_SIZE;
+    dcLevel /= length;
 
-    q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));;
+    q15_t offset = q15_t(__SSAT(q31_t(dcLevel >> 16), 16));
 
     q15_t dcSamples[RX_BLOCK_SIZE];
-    for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
+    for (uint16_t i = 0U; i < length; i++)
       dcSamples[i] = samples[i] - offset;
-#endif
-
-    if (m_modemState == STATE_IDLE) {
-      if (m_dstarEnable) {
-        q15_t GMSKVals[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_gaussianFilter, dcSamples, GMSKVals, RX_BLOCK_SIZE);
 #else
-        ::arm_fir_fast_q15(&m_gaussianFilter, samples, GMSKVals, RX_BLOCK_SIZE);
+    q15_t* dcSamples = samples;
 #endif
-        dstarRX.samples(GMSKVals, rssi, RX_BLOCK_SIZE);
-      }
 
-      if (m_p25Enable) {
-        q15_t P25Vals[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_boxcarFilter, dcSamples, P25Vals, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_boxcarFilter, samples, P25Vals, RX_BLOCK_SIZE);
-#endif
-        p25RX.samples(P25Vals, rssi, RX_BLOCK_SIZE);
-      }
+    // Pick the filter outputs this state needs, then run them all in one pass over the block
+    q15_t GMSKVals[RX_BLOCK_SIZE];
+    q15_t P25Vals[RX_BLOCK_SIZE];
+    q15_t NXDNVals[RX_BLOCK_SIZE];
+    q15_t RRCVals[RX_BLOCK_SIZE];
+
+    q15_t* filtered[RX_FILTER_COUNT] = {NULL};
+
+    bool idle = m_modemState == STATE_IDLE;
+
+    if (m_dstarEnable && (idle || m_modemState == STATE_DSTAR))
+      filtered[RX_FILTER_GAUSSIAN] = GMSKVals;
+    if (m_modemState == STATE_DSTARCAL)
+      filtered[RX_FILTER_GAUSSIAN_RAW] = GMSKVals;
+    if (m_p25Enable && (idle || m_modemState == STATE_P25))
+      filtered[RX_FILTER_BOXCAR] = P25Vals;
+    if (m_nxdnEnable && (idle || m_modemState == STATE_NXDN))
+      filtered[RX_FILTER_NXDN] = NXDNVals;
+    if ((idle && (m_dmrEnable || m_ysfEnable)) || (m_dmrEnable && m_modemState == STATE_DMR))
+      filtered[RX_FILTER_RRC] = RRCVals;
+    if (m_ysfEnable && m_modemState == STATE_YSF)
+      filtered[RX_FILTER_RRC_DC] = RRCVals;
+
+    const q15_t* inputs[RX_FILTER_INPUTS] = {samples, dcSamples};
+    m_rxFilters.process(inputs, length, filtered);
+
+    // Decimate the 4FSK matched filter outputs to the samples per symbol of their receivers,
+    // carrying the RSSI and the DMR slot marks along
+    q15_t    RRCSyms[RX_BLOCK_SIZE];
+    uint16_t RRCRSSI[RX_BLOCK_SIZE];
+    uint8_t  RRCControl[RX_BLOCK_SIZE];
+    uint16_t RRCLength = 0U;
+    if (filtered[RX_FILTER_RRC] != NULL || filtered[RX_FILTER_RRC_DC] != NULL)
+      RRCLength = m_rrcDecimator.process(RRCVals, rssi, control, length, RRCSyms, RRCRSSI, RRCControl);
+
+    q15_t    P25Syms[RX_BLOCK_SIZE];
+    uint16_t P25RSSI[RX_BLOCK_SIZE];
+    uint16_t P25Length = 0U;
+    if (filtered[RX_FILTER_BOXCAR] != NULL)
+      P25Length = m_p25Decimator.process(P25Vals, rssi, NULL, length, P25Syms, P25RSSI, NULL);
+
+    q15_t    NXDNSyms[RX_BLOCK_SIZE];
+    uint16_t NXDNRSSI[RX_BLOCK_SIZE];
+    uint16_t NXDNLength = 0U;
+    if (filtered[RX_FILTER_NXDN] != NULL)
+      NXDNLength = m_nxdnDecimator.process(NXDNVals, rssi, NULL, length, NXDNSyms, NXDNRSSI, NULL);
+
+    // Recover the symbol centres for the receivers that sync on one value per symbol. The duplex
+    // DMR receivers stay on the decimated samples as their slots are locked to the TX slot marks.
+    q15_t    RRCSymbols[RX_BLOCK_SIZE];
+    uint16_t RRCSymbolsRSSI[RX_BLOCK_SIZE];
+    uint16_t RRCSymbolsLength = 0U;
+    if (RRCLength > 0U)
+      RRCSymbolsLength = m_rrcTiming.process(RRCSyms, RRCRSSI, RRCLength, RRCSymbols, RRCSymbolsRSSI);
+
+    q15_t    P25Symbols[RX_BLOCK_SIZE];
+    uint16_t P25SymbolsRSSI[RX_BLOCK_SIZE];
+    uint16_t P25SymbolsLength = 0U;
+    if (P25Length > 0U)
+      P25SymbolsLength = m_p25Timing.process(P25Syms, P25RSSI, P25Length, P25Symbols, P25SymbolsRSSI);
+
+    q15_t    NXDNSymbols[RX_BLOCK_SIZE];
+    uint16_t NXDNSymbolsRSSI[RX_BLOCK_SIZE];
+    uint16_t NXDNSymbolsLength = 0U;
+    if (NXDNLength > 0U)
+      NXDNSymbolsLength = m_nxdnTiming.process(NXDNSyms, NXDNRSSI, NXDNLength, NXDNSymbols, NXDNSymbolsRSSI);
 
-      if (m_nxdnEnable) {
-        q15_t NXDNValsTmp[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_nxdnFilter, dcSamples, NXDNValsTmp, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_nxdnFilter, samples, NXDNValsTmp, RX_BLOCK_SIZE);
-#endif
-        q15_t NXDNVals[RX_BLOCK_SIZE];
-        ::arm_fir_fast_q15(&m_nxdnISincFilter, NXDNValsTmp, NXDNVals, RX_BLOCK_SIZE);
+    if (m_modemState == STATE_IDLE) {
+      if (m_dstarEnable)
+        dstarRX.samples(GMSKVals, rssi, length);
 
-        nxdnRX.samples(NXDNVals, rssi, RX_BLOCK_SIZE);
-      }
+      if (m_p25Enable)
+        p25RX.samples(P25Symbols, P25SymbolsRSSI, P25SymbolsLength);
 
-      if (m_dmrEnable || m_ysfEnable) {
-        q15_t RRCVals[RX_BLOCK_SIZE];
-        ::arm_fir_fast_q15(&m_rrcFilter, samples, RRCVals, RX_BLOCK_SIZE);
+      if (m_nxdnEnable)
+        nxdnRX.samples(NXDNSymbols, NXDNSymbolsRSSI, NXDNSymbolsLength);
 
+      if (m_dmrEnable || m_ysfEnable) {
         if (m_ysfEnable)
-          ysfRX.samples(RRCVals, rssi, RX_BLOCK_SIZE);
+          ysfRX.samples(RRCSymbols, RRCSymbolsRSSI, RRCSymbolsLength);
 
         if (m_dmrEnable) {
           if (m_duplex)
-            dmrIdleRX.samples(RRCVals, RX_BLOCK_SIZE);
+            dmrIdleRX.samples(RRCSyms, RRCLength);
           else
-            dmrDMORX.samples(RRCVals, rssi, RX_BLOCK_SIZE);
+            dmrDMORX.samples(RRCSymbols, RRCSymbolsRSSI, RRCSymbolsLength);
         }
       }
     } else if (m_modemState == STATE_DSTAR) {
-      if (m_dstarEnable) {
-        q15_t GMSKVals[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_gaussianFilter, dcSamples, GMSKVals, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_gaussianFilter, samples, GMSKVals, RX_BLOCK_SIZE);
-#endif
-        dstarRX.samples(GMSKVals, rssi, RX_BLOCK_SIZE);
-      }
+      if (m_dstarEnable)
+        dstarRX.samples(GMSKVals, rssi, length);
     } else if (m_modemState == STATE_DMR) {
       if (m_dmrEnable) {
-        q15_t DMRVals[RX_BLOCK_SIZE];
-        ::arm_fir_fast_q15(&m_rrcFilter, samples, DMRVals, RX_BLOCK_SIZE);
-
         if (0) {
           // If the transmitter isn't on, use the DMR idle RX to detect the wakeup CSBKs
           if (m_tx)
-            dmrRX.samples(DMRVals, rssi, control, RX_BLOCK_SIZE);
+            dmrRX.samples(RRCSyms, RRCRSSI, RRCControl, RRCLength);
           else
-            dmrIdleRX.samples(DMRVals, RX_BLOCK_SIZE);
+            dmrIdleRX.samples(RRCSyms, RRCLength);
         } else {
-          dmrDMORX.samples(DMRVals, rssi, RX_BLOCK_SIZE);
+          dmrDMORX.samples(RRCSymbols, RRCSymbolsRSSI, RRCSymbolsLength);
         }
       }
     } else if (m_modemState == STATE_YSF) {
-      if (m_ysfEnable) {
-        q15_t YSFVals[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_rrcFilter, dcSamples, YSFVals, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_rrcFilter, samples, YSFVals, RX_BLOCK_SIZE);
-#endif
-        ysfRX.samples(YSFVals, rssi, RX_BLOCK_SIZE);
-      }
+      if (m_ysfEnable)
+        ysfRX.samples(RRCSymbols, RRCSymbolsRSSI, RRCSymbolsLength);
     } else if (m_modemState == STATE_P25) {
-      if (m_p25Enable) {
-        q15_t P25Vals[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_boxcarFilter, dcSamples, P25Vals, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_boxcarFilter, samples, P25Vals, RX_BLOCK_SIZE);
-#endif
-        p25RX.samples(P25Vals, rssi, RX_BLOCK_SIZE);
-      }
+      if (m_p25Enable)
+        p25RX.samples(P25Symbols, P25SymbolsRSSI, P25SymbolsLength);
     } else if (m_modemState == STATE_NXDN) {
-      if (m_nxdnEnable) {
-        q15_t NXDNValsTmp[RX_BLOCK_SIZE];
-#if defined(USE_DCBLOCKER)
-        ::arm_fir_fast_q15(&m_nxdnFilter, dcSamples, NXDNValsTmp, RX_BLOCK_SIZE);
-#else
-        ::arm_fir_fast_q15(&m_nxdnFilter, samples, NXDNValsTmp, RX_BLOCK_SIZE);
-#endif
-        q15_t NXDNVals[RX_BLOCK_SIZE];
-        ::arm_fir_fast_q15(&m_nxdnISincFilter, NXDNValsTmp, NXDNVals, RX_BLOCK_SIZE);
-
-        nxdnRX.samples(NXDNVals, rssi, RX_BLOCK_SIZE);
-      }
+      if (m_nxdnEnable)
+        nxdnRX.samples(NXDNSymbols, NXDNSymbolsRSSI, NXDNSymbolsLength);
     } else if (m_modemState == STATE_DSTARCAL) {
-      q15_t GMSKVals[RX_BLOCK_SIZE];
-      ::arm_fir_fast_q15(&m_gaussianFilter, samples, GMSKVals, RX_BLOCK_SIZE);
-
-      calDStarRX.samples(GMSKVals, RX_BLOCK_SIZE);
+      calDStarRX.samples(GMSKVals, length);
     } else if (m_modemState == STATE_RSSICAL) {
-      calRSSI.samples(rssi, RX_BLOCK_SIZE);
+      calRSSI.samples(rssi, length);
     }
   }
-  }
 }
 
 void CIO::write(MMDVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* control)
 {
+  if (!m_started)
+    return;
 
+  if (m_lockout)
+    return;
+
+  // Level the samples in chunks and hand each chunk to the ring in one go
+  uint16_t out[TX_WRITE_CHUNK];
+  for (uint16_t pos = 0U; pos < length; pos += TX_WRITE_CHUNK) {
+    uint16_t n = length - pos;
+    if (n > TX_WRITE_CHUNK)
+      n = TX_WRITE_CHUNK;
+
+    scale(mode, samples + pos, out, n);
+
+    writeScaled(out, n, control == NULL ? NULL : control + pos);
+  }
+}
+
+void CIO::writeScaled(const uint16_t* samples, uint16_t length, const uint8_t* control)
+{
   if (!m_started)
     return;
 
@@ -502,6 +550,16 @@ void CIO::write(MMDVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t
     setPTTInt(m_pttInvert ? false : true);
   }
 
+  m_txBuffer.put(samples, control, 0U, length);
+
+  // Pairs with the fence in the TX thread so either it sees the samples or we see it waiting
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_txWaiting.load(std::memory_order_relaxed) && m_txBuffer.getData() >= TX_WAKE_THRESHOLD)
+    m_txEvent.signal();
+}
+
+void CIO::scale(MMDVM_STATE mode, const q15_t* samples, uint16_t* out, uint16_t length) const
+{
   q15_t txLevel = 0;
   switch (mode) {
     case STATE_DSTAR:
@@ -523,32 +581,22 @@ void CIO::write(MMDVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t
       txLevel = m_cwIdTXLevel;
       break;
   }
-    ::pthread_mutex_lock(&m_TXlock);
+
   for (uint16_t i = 0U; i < length; i++) {
     q31_t res1 = samples[i] * txLevel;
     q15_t res2 = q15_t(__SSAT((res1 >> 15), 16));
-    uint16_t res3 = uint16_t(res2); // + m_txDCOffset);
-	//DEBUG2("txDCoffset: %d", m_txDCOffset);
-
-    // Detect DAC overflow
-    //if (res3 > 4095U)
-      //m_dacOverflow++;
-
-    
-   if (control == NULL)
-     m_txBuffer.put(res3, MARK_NONE);
-   else
-     m_txBuffer.put(res3, control[i]);
+    out[i] = uint16_t(res2); // + m_txDCOffset);
   }
-  ::pthread_mutex_unlock(&m_TXlock);
+}
+
+uint32_t CIO::getLevelSerial() const
+{
+  return m_levelSerial;
 }
 
 uint16_t CIO::getSpace() 
 {
-    ::pthread_mutex_lock(&m_TXlock);
-    u_int16_t space = m_txBuffer.getSpace();
-    ::pthread_mutex_unlock(&m_TXlock);
-  return space;
+  return m_txBuffer.getSpace();
 }
 
 void CIO::setDecode(bool dcd)
@@ -603,6 +651,9 @@ void CIO::setParameters(bool rxInvert, bool txInvert, bool pttInvert, uint8_t rx
     m_p25TXLevel   = -m_p25TXLevel;
     m_nxdnTXLevel  = -m_nxdnTXLevel;
   }
+
+  // Anything scaled at the old levels is now stale
+  m_levelSerial++;
 }
 
 void CIO::getOverflow(bool& adcOverflow, bool& dacOverflow)
@@ -616,18 +667,12 @@ void CIO::getOverflow(bool& adcOverflow, bool& dacOverflow)
 
 bool CIO::hasTXOverflow()
 {
-    ::pthread_mutex_lock(&m_TXlock);
-    bool has_overflowed = m_txBuffer.hasOverflowed();
-    ::pthread_mutex_unlock(&m_TXlock);
-  return has_overflowed;
+  return m_txBuffer.hasOverflowed();
 }
 
 bool CIO::hasRXOverflow()
 {
-    ::pthread_mutex_lock(&m_RXlock);
-    bool has_overflowed = m_rxBuffer.hasOverflowed();
-    ::pthread_mutex_unlock(&m_RXlock);
-  return has_overflowed;
+  return m_rxBuffer.hasOverflowed();
 }
 
 void CIO::resetWatchdog()
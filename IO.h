@@ -24,8 +24,47 @@
 #include "Globals.h"
 
 #include "SampleRB.h"
-#include "RSSIRB.h"
 #include "SoapySxFrontend.h"
+#include "FMDemod.h"
+#include "FMMod.h"
+#include "Resampler.h"
+#include "Decimator.h"
+#include "Channelizer.h"
+#include "Synthesizer.h"
+#include "FusedFIR.h"
+#include "SymbolDecimator.h"
+#include "SymbolTiming.h"
+#include "Event.h"
+#include "RealTime.h"
+
+#include <atomic>
+
+// Number of IQ samples exchanged with the SDR per stream call
+const uint16_t SDR_BLOCK_SIZE = 512U;
+
+// Largest block of RX samples filtered and decoded in one pass, 20 ms at the modem rate
+const uint16_t RX_BLOCK_SIZE = 480U;
+
+// Inputs and outputs of the fused RX filters
+enum RX_FILTER_INPUT {
+  RX_INPUT_RAW = 0,
+  RX_INPUT_DC,
+  RX_FILTER_INPUTS
+};
+
+enum RX_FILTER {
+  RX_FILTER_GAUSSIAN = 0,
+  RX_FILTER_GAUSSIAN_RAW,
+  RX_FILTER_BOXCAR,
+  RX_FILTER_NXDN,
+  RX_FILTER_RRC,
+  RX_FILTER_RRC_DC,
+  RX_FILTER_COUNT
+};
+
+// A sleeping TX thread is woken once this many samples are queued, the main loop flushes
+// anything smaller before it goes to sleep itself
+const uint16_t TX_WAKE_THRESHOLD = 48U;
 
 class CIO {
 public:
@@ -37,6 +76,11 @@ public:
 
   void write(MMDVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* control = NULL);
 
+  // For samples already put through scale(), valid for as long as getLevelSerial() is unchanged
+  void writeScaled(const uint16_t* samples, uint16_t length, const uint8_t* control = NULL);
+  void scale(MMDVM_STATE mode, const q15_t* samples, uint16_t* out, uint16_t length) const;
+  uint32_t getLevelSerial() const;
+
   uint16_t getSpace();
 
   void setDecode(bool dcd);
@@ -46,6 +90,10 @@ public:
   void interrupt();
   void interruptRX();
 
+  // Sleeps the main loop until the RX or TX thread has work for it, fd becomes readable or
+  // a housekeeping timeout passes
+  void wait(int fd);
+
   void setParameters(bool rxInvert, bool txInvert, bool pttInvert, uint8_t rxLevel, uint8_t cwIdTXLevel, uint8_t dstarTXLevel, uint8_t dmrTXLevel, uint8_t ysfTXLevel, uint8_t p25TXLevel, uint8_t nxdnLevel, int16_t txDCOffset, int16_t rxDCOffset);
 
   void getOverflow(bool& adcOverflow, bool& dacOverflow);
@@ -68,21 +116,27 @@ private:
 
   CSampleRB            m_rxBuffer;
   CSampleRB            m_txBuffer;
-  CRSSIRB              m_rssiBuffer;
+
+  CRTProfile            m_mainProfile;
+  CRTProfile            m_txProfile;
+  CRTProfile            m_rxProfile;
+
+  CEvent                m_dspEvent;
+  CEvent                m_txEvent;
+  std::atomic<bool>     m_txWaiting;
+  std::atomic<uint32_t> m_rxWakeups;
+  uint64_t              m_wakeupTime;
 
   arm_biquad_casd_df1_inst_q31 m_dcFilter;
   q31_t                        m_dcState[4];
 
-  arm_fir_instance_q15 m_rrcFilter;
-  arm_fir_instance_q15 m_gaussianFilter;
-  arm_fir_instance_q15 m_boxcarFilter;
-  arm_fir_instance_q15 m_nxdnFilter;
-  arm_fir_instance_q15 m_nxdnISincFilter;
-  q15_t                m_rrcState[70U];           // NoTaps + BlockSize - 1, 42 + 20 - 1 plus some spare
-  q15_t                m_gaussianState[40U];      // NoTaps + BlockSize - 1, 12 + 20 - 1 plus some spare
-  q15_t                m_boxcarState[30U];        // NoTaps + BlockSize - 1, 6 + 20 - 1 plus some spare
-  q15_t                m_nxdnState[110U];         // NoTaps + BlockSize - 1, 82 + 20 - 1 plus some spare
-  q15_t                m_nxdnISincState[60U];     // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
+  CFusedFIR            m_rxFilters;
+  CSymbolDecimator     m_rrcDecimator;
+  CSymbolDecimator     m_p25Decimator;
+  CSymbolDecimator     m_nxdnDecimator;
+  CSymbolTiming        m_rrcTiming;
+  CSymbolTiming        m_p25Timing;
+  CSymbolTiming        m_nxdnTiming;
 
   bool                 m_pttInvert;
   q15_t                m_rxLevel;
@@ -92,6 +146,7 @@ private:
   q15_t                m_ysfTXLevel;
   q15_t                m_p25TXLevel;
   q15_t                m_nxdnTXLevel;
+  uint32_t             m_levelSerial;
 
   uint16_t             m_rxDCOffset;
   uint16_t             m_txDCOffset;
@@ -113,17 +168,46 @@ private:
   double             m_centerFrequency;
   double             m_rxGainDb;
   double             m_txGainDb;
+  float              m_txDeviation;
+  uint16_t           m_channels;
+  int                m_channel;
+
+  // RX channelization, only the selected channel is kept
+  CChannelizer        m_channelizer;
+  std::complex<float> m_rxChannel[SDR_BLOCK_SIZE];
+  std::complex<float>* m_rxChannels[CHANNELIZER_MAX_CHANNELS];
+
+  // RX decimation from the SDR rate down to the discriminator rate
+  CDecimator          m_decimator;
+  uint16_t            m_rxReadSize;
+  SX_IQ_FORMAT        m_rxFormat;
+  uint8_t             m_rxSampleBytes;
+  std::complex<float> m_rxIQ[SDR_BLOCK_SIZE];
+  q15_t               m_rxIQ15[2U * SDR_BLOCK_SIZE];
+  int8_t              m_rxIQ8[2U * SDR_BLOCK_SIZE];
+  q15_t               m_rxI[SDR_BLOCK_SIZE];
+  q15_t               m_rxQ[SDR_BLOCK_SIZE];
+
+  // RX demodulation
+  CFMDemod           m_fmDemod;
+  q15_t              m_rxDemod[SDR_BLOCK_SIZE];
+
+  // TX modulation
+  CFMMod              m_fmMod;
+  q15_t               m_txBaseband[SDR_BLOCK_SIZE];
+  std::complex<float> m_txIQ[SDR_BLOCK_SIZE];
+
+  // TX synthesis, the modem drives the selected channel and the rest stay silent
+  CSynthesizer               m_synthesizer;
+  std::complex<float>        m_txWide[SDR_BLOCK_SIZE];
+  const std::complex<float>* m_txChannels[CHANNELIZER_MAX_CHANNELS];
+
+  // Resampling between the SDR rate and the modem rate
+  CResampler         m_rxResampler;
+  CResampler         m_txResampler;
+  q15_t              m_rxModem[SDR_BLOCK_SIZE];
+  q15_t              m_txModem[SDR_BLOCK_SIZE];
 
-  // Resampling helpers
-  double             m_rxResampleRatio;
-  double             m_txResampleRatio;
-  double             m_rxFrac;
-  double             m_txFrac;
-  q15_t              m_prevRxSample;
-  q15_t              m_prevTxSample;
-
-  pthread_mutex_t m_TXlock;
-  pthread_mutex_t m_RXlock;
   bool m_COSint;
 
   // Hardware specific routines
@@ -131,6 +215,9 @@ private:
   void startInt();
   static void* helper(void* arg);
   static void* helperRX(void* arg);
+  uint16_t processTx(std::complex<float>* out, uint16_t space);
+  void processRx(const void* in, uint16_t length);
+  static void floatToQ15(const float* in, q15_t* out, uint16_t length);
   bool getCOSInt();
 
   void setLEDInt(bool on);
@@ -24,8 +24,6 @@
 #include "Globals.h"
 #include "IO.h"
 #include <pthread.h>
-#include <vector>
-#include <algorithm>
 #include <complex>
 
 #if defined(RPI)
@@ -37,10 +35,20 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <time.h>
 
 
 const uint16_t DC_OFFSET = 2048U;
 
+// Upper bounds on how long each thread sleeps when nothing wakes it
+const int DSP_WAIT_TIMEOUT_MS = 20;
+const int TX_WAIT_TIMEOUT_MS  = 100;
+
+// Back off for this long when the RX stream isn't running rather than spin on its errors
+const useconds_t RX_IDLE_DELAY_US = 100000U;
+
+const uint64_t WAKEUP_REPORT_INTERVAL_MS = 60000U;
+
 unsigned char wavheader[] = {0x52,0x49,0x46,0x46,0xb8,0xc0,0x8f,0x00,0x57,0x41,0x56,0x45,0x66,0x6d,0x74,0x20,0x10,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0xc0,0x5d,0x00,0x00,0x80,0xbb,0x00,0x00,0x02,0x00,0x10,0x00,0x64,0x61,0x74,0x61,0xff,0xff,0xff,0xff};
 
 void CIO::initInt()
@@ -49,22 +57,15 @@ void CIO::initInt()
 //	std::cout << "IO Init" << std::endl;
 	DEBUG1("IO Init done! Thread Started!");
 
+	m_dspEvent.open();
+	m_txEvent.open();
+
 }
 
 void CIO::startInt()
 {
 
         DEBUG1("IO Int start()");
-    if (::pthread_mutex_init(&m_TXlock, NULL) != 0)
-    {
-        printf("\n Tx mutex init failed\n");
-        exit(1);;
-    }
-    if (::pthread_mutex_init(&m_RXlock, NULL) != 0)
-    {
-        printf("\n RX mutex init failed\n");
-        exit(1);;
-    }
 
     if (!m_frontend.open()) {
         LogError("Failed to open SoapySX frontend");
@@ -75,10 +76,73 @@ void CIO::startInt()
             LogError("Failed to start TX stream");
 
         m_sdrSampleRate = m_frontend.getSampleRate();
-        m_rxResampleRatio = m_sdrSampleRate / double(MODEM_SAMPLE_RATE);
-        m_txResampleRatio = m_sdrSampleRate / double(MODEM_SAMPLE_RATE);
+
+        m_rxFormat      = m_frontend.getRxFormat();
+        m_rxSampleBytes = (m_rxFormat == IQ_CS16) ? 4U : (m_rxFormat == IQ_CS8) ? 2U : 8U;
+
+        const char* formats[] = {"auto", "CF32", "CS16", "CS8"};
+        LogMessage("RX %s %s, MTU %u samples", formats[m_rxFormat], m_frontend.hasRxDirectAccess() ? "direct buffer access" : "copying reads", (unsigned int)m_frontend.getRxMTU());
+        LogMessage("TX %s, MTU %u samples", m_frontend.hasTxDirectAccess() ? "direct buffer access" : "copying writes", (unsigned int)m_frontend.getTxMTU());
+        LogMessage("DSP kernels: %s", ::arm_math_backend());
+
+        uint32_t sdrRate = uint32_t(m_sdrSampleRate + 0.5);
+
+        // Split the wideband stream into channels spaced by the sample rate over the channel count
+        uint32_t channelRate  = sdrRate;
+        uint32_t channelDecim = 1U;
+        if (m_channels > 1U) {
+            if (!m_channelizer.setChannels(m_channels) || !m_synthesizer.setChannels(m_channels)) {
+                LogError("Cannot channelize into %u channels, a power of two up to %u is needed", m_channels, CHANNELIZER_MAX_CHANNELS);
+                m_channels = 1U;
+            } else {
+                int index = ((m_channel % int(m_channels)) + int(m_channels)) % int(m_channels);
+                m_rxChannels[index] = m_rxChannel;
+                m_txChannels[index] = m_txIQ;
+
+                channelDecim = m_channelizer.getDecimation();
+                channelRate  = sdrRate / channelDecim;
+                LogMessage("Channelizer %u channels of %u Hz, using channel %d at %u samples/s", m_channels, sdrRate / m_channels, m_channel, channelRate);
+            }
+        }
+
+        m_fmMod.setSampleRate(double(channelRate));
+        m_fmMod.setDeviation(m_txDeviation);
+
+        // Keep at least twice the modem rate into the discriminator so the resampler has room for its transition band
+        uint32_t demodRate = m_decimator.setRates(channelRate, 2U * MODEM_SAMPLE_RATE);
+        LogMessage("RX decimation %u, CIC %u, %u half-band stages, %u samples/s", m_decimator.getDecimation(), m_decimator.getCICDecimation(), m_decimator.getHalfBands(), demodRate);
+
+        m_fmDemod.setSampleRate(double(demodRate));
+
+        if (!m_rxResampler.setRates(demodRate, MODEM_SAMPLE_RATE))
+            LogError("Cannot resample RX from %u to %u samples/s", demodRate, MODEM_SAMPLE_RATE);
+        else
+            LogMessage("RX resampler %u/%u, %u taps per phase", m_rxResampler.getInterpolation(), m_rxResampler.getDecimation(), m_rxResampler.getTaps());
+
+        // Read no more than the resampler can take once decimated, in whole decimation periods
+        uint32_t decimation = m_decimator.getDecimation() * channelDecim;
+        if (decimation > SDR_BLOCK_SIZE) {
+            // A read would not hold one decimated sample and the RX loop could never advance
+            LogError("RX decimation %u is more than the %u sample read block, lower SX_SAMPLE_RATE or set SX_CHANNELS", decimation, SDR_BLOCK_SIZE);
+            m_frontend.stopRx();
+            decimation = SDR_BLOCK_SIZE;
+        }
+
+        uint32_t readSize   = uint32_t(m_rxResampler.getMaxInput(SDR_BLOCK_SIZE)) * decimation;
+        if (readSize > SDR_BLOCK_SIZE)
+            readSize = SDR_BLOCK_SIZE - SDR_BLOCK_SIZE % decimation;
+        m_rxReadSize = uint16_t(readSize);
+
+        if (!m_txResampler.setRates(MODEM_SAMPLE_RATE, channelRate))
+            LogError("Cannot resample TX from %u to %u samples/s", MODEM_SAMPLE_RATE, channelRate);
+        else
+            LogMessage("TX resampler %u/%u, %u taps per phase", m_txResampler.getInterpolation(), m_txResampler.getDecimation(), m_txResampler.getTaps());
     }
 
+    // The main loop runs the decoders and transmitters, startInt is called from it
+    RTLockMemory();
+    m_mainProfile.apply();
+
     ::pthread_create(&m_thread, NULL, helper, this);
     ::pthread_create(&m_threadRX, NULL, helperRX, this);
 }
@@ -87,10 +151,20 @@ void* CIO::helper(void* arg)
 {
   CIO* p = (CIO*)arg;
 
+  p->m_txProfile.apply();
+
   while (1)
   {
-      if(p->m_txBuffer.getData() < 1)
-        usleep(20);
+    if (p->m_txBuffer.getData() == 0U) {
+      p->m_txWaiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (p->m_txBuffer.getData() == 0U)
+        p->m_txEvent.wait(TX_WAIT_TIMEOUT_MS);
+
+      p->m_txWaiting.store(false, std::memory_order_relaxed);
+    }
+
     p->interrupt();
   }
 
@@ -101,73 +175,204 @@ void* CIO::helperRX(void* arg)
 {
   CIO* p = (CIO*)arg;
 
+  p->m_rxProfile.apply();
+
+  // The reads block in the driver until a buffer is ready
   while (1)
   {
+    if (!p->m_frontend.isRxRunning()) {
+      ::usleep(RX_IDLE_DELAY_US);
+      continue;
+    }
 
-    usleep(20);
+    p->m_rxWakeups.fetch_add(1U, std::memory_order_relaxed);
     p->interruptRX();
   }
 
   return NULL;
 }
 
+void CIO::wait(int fd)
+{
+  // Samples may have arrived while the last pass was running
+  if (m_rxBuffer.getData() > 0U)
+    return;
+
+  // Let the TX thread have a tail shorter than its wake threshold
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_txWaiting.load(std::memory_order_relaxed) && m_txBuffer.getData() > 0U)
+    m_txEvent.signal();
+
+  m_dspEvent.wait(DSP_WAIT_TIMEOUT_MS, fd);
+
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t now = uint64_t(ts.tv_sec) * 1000U + uint64_t(ts.tv_nsec) / 1000000U;
+
+  if (m_wakeupTime == 0U) {
+    m_wakeupTime = now;
+  } else if (now - m_wakeupTime >= WAKEUP_REPORT_INTERVAL_MS) {
+    uint32_t secs = uint32_t((now - m_wakeupTime) / 1000U);
+    uint32_t dsp  = m_dspEvent.getWakeups();
+    uint32_t tx   = m_txEvent.getWakeups();
+    uint32_t rx   = m_rxWakeups.exchange(0U, std::memory_order_relaxed);
+
+    LogDebug("Wakeups per second: main %u, TX %u, RX %u", dsp / secs, tx / secs, rx / secs);
+
+    m_wakeupTime = now;
+  }
+}
 
 void CIO::interrupt()
 {
-    std::vector<std::complex<float>> iqOut;
-    iqOut.reserve(512);
-
-    ::pthread_mutex_lock(&m_TXlock);
-    while (iqOut.size() < 512 && m_txBuffer.getData() > 0) {
-        uint16_t sample = 0;
-        uint8_t control = MARK_NONE;
-        m_txBuffer.get(sample, control);
-
-        q15_t current = q15_t(sample);
-        double step = m_txResampleRatio;
-        double pos = m_txFrac;
-        while (pos < step && iqOut.size() < 512) {
-            double interp = m_prevTxSample + (current - m_prevTxSample) * (pos / step);
-            float scaled = float(std::clamp(interp / 32768.0, -1.0, 1.0));
-            iqOut.emplace_back(scaled, 0.0f);
-            pos += 1.0;
+    if (m_txBuffer.getData() == 0U)
+        return;
+
+    // Modulate straight into the driver's buffer when it lets us
+    if (m_frontend.hasTxDirectAccess()) {
+        std::complex<float>* buf = NULL;
+        size_t handle = 0U;
+        int room = m_frontend.acquireTx(buf, handle);
+        if (room < 0)
+            return;
+
+        uint16_t len = processTx(buf, room > int(SDR_BLOCK_SIZE) ? SDR_BLOCK_SIZE : uint16_t(room));
+
+        m_frontend.releaseTx(handle, len);
+
+        // Room has opened up in the TX ring for the transmitters
+        if (len > 0U)
+            m_dspEvent.signal();
+    } else {
+        std::complex<float>* out = (m_channels > 1U) ? m_txWide : m_txIQ;
+
+        uint16_t len = processTx(out, SDR_BLOCK_SIZE);
+        if (len > 0U) {
+            m_dspEvent.signal();
+            m_frontend.writeIq(out, len);
         }
-        m_txFrac = pos - step;
-        m_prevTxSample = current;
     }
-    ::pthread_mutex_unlock(&m_TXlock);
+}
+
+uint16_t CIO::processTx(std::complex<float>* out, uint16_t space)
+{
+    // With the synthesis bank every baseband sample becomes N / 2 wideband ones
+    if (m_channels > 1U)
+        space /= m_synthesizer.getInterpolation();
+
+    if (space == 0U)
+        return 0U;
+
+    uint16_t max = m_txResampler.getMaxInput(space);
+    if (max > SDR_BLOCK_SIZE)
+        max = SDR_BLOCK_SIZE;
+
+    uint16_t n = m_txBuffer.get(reinterpret_cast<uint16_t*>(m_txModem), NULL, NULL, max);
+
+    if (n == 0U)
+        return 0U;
+
+    uint16_t len = m_txResampler.process(m_txModem, n, m_txBaseband);
+
+    if (m_channels > 1U) {
+        m_fmMod.process(m_txBaseband, m_txIQ, len);
+        return m_synthesizer.process(m_txChannels, len, out);
+    }
+
+    m_fmMod.process(m_txBaseband, out, len);
 
-    if (!iqOut.empty())
-        m_frontend.writeIq(iqOut.data(), iqOut.size());
+    return len;
 }
 
 void CIO::interruptRX()
 {
-    std::complex<float> rxBuf[512];
-    int got = m_frontend.readIq(rxBuf, 512);
-    if (got <= 0)
-        return;
+    // Demodulate straight from the driver's buffer when it lets us, in read size pieces
+    if (m_frontend.hasRxDirectAccess()) {
+        const void* buf = NULL;
+        size_t handle = 0U;
+        int got = m_frontend.acquireRx(buf, handle);
+        if (got < 0)
+            return;
+
+        const uint8_t* p = static_cast<const uint8_t*>(buf);
+        for (int pos = 0; pos < got; pos += m_rxReadSize) {
+            int len = got - pos;
+            processRx(p + pos * m_rxSampleBytes, len > int(m_rxReadSize) ? m_rxReadSize : uint16_t(len));
+        }
 
-    double step = m_rxResampleRatio;
-    double acc = m_rxFrac;
+        m_frontend.releaseRx(handle);
+    } else {
+        void* buf = m_rxIQ;
+        if (m_rxFormat == IQ_CS16)
+            buf = m_rxIQ15;
+        else if (m_rxFormat == IQ_CS8)
+            buf = m_rxIQ8;
 
-    ::pthread_mutex_lock(&m_RXlock);
-    for (int i = 0; i < got; ++i) {
-        float realVal = rxBuf[i].real();
-        realVal = std::clamp(realVal, -1.0f, 1.0f);
-        q15_t current = q15_t(realVal * 32767.0f);
+        int got = m_frontend.readIq(buf, m_rxReadSize);
+        if (got <= 0)
+            return;
 
-        acc += 1.0;
-        if (acc >= step) {
-            m_rxBuffer.put(uint16_t(current), MARK_NONE);
-            m_rssiBuffer.put(uint16_t(std::abs(current)));
-            acc -= step;
+        processRx(buf, uint16_t(got));
+    }
+}
+
+void CIO::processRx(const void* in, uint16_t length)
+{
+    const q15_t* iq15 = m_rxIQ15;
+
+    if (m_channels > 1U) {
+        // The channelizer works in float, widen the fixed point formats first
+        const std::complex<float>* wide = m_rxIQ;
+        if (m_rxFormat == IQ_CF32) {
+            wide = static_cast<const std::complex<float>*>(in);
+        } else if (m_rxFormat == IQ_CS16) {
+            const q15_t* src = static_cast<const q15_t*>(in);
+            for (uint16_t i = 0U; i < length; i++)
+                m_rxIQ[i] = std::complex<float>(float(src[2U * i]) / 32768.0F, float(src[2U * i + 1U]) / 32768.0F);
+        } else {
+            const int8_t* src = static_cast<const int8_t*>(in);
+            for (uint16_t i = 0U; i < length; i++)
+                m_rxIQ[i] = std::complex<float>(float(src[2U * i]) / 128.0F, float(src[2U * i + 1U]) / 128.0F);
         }
-        m_prevRxSample = current;
+
+        length = m_channelizer.process(wide, length, m_rxChannels);
+        if (length == 0U)
+            return;
+
+        floatToQ15(reinterpret_cast<const float*>(m_rxChannel), m_rxIQ15, 2U * length);
+    } else if (m_rxFormat == IQ_CS16) {
+        // Already q15, straight into the decimator
+        iq15 = static_cast<const q15_t*>(in);
+    } else if (m_rxFormat == IQ_CS8) {
+        const int8_t* src = static_cast<const int8_t*>(in);
+        for (uint16_t i = 0U; i < 2U * length; i++)
+            m_rxIQ15[i] = q15_t(src[i] * 256);
+    } else {
+        floatToQ15(static_cast<const float*>(in), m_rxIQ15, 2U * length);
+    }
+
+    uint16_t n = m_decimator.process(iq15, length, m_rxI, m_rxQ);
+    if (n == 0U)
+        return;
+
+    uint16_t rssi = m_fmDemod.process(m_rxI, m_rxQ, m_rxDemod, n);
+
+    uint16_t len = m_rxResampler.process(m_rxDemod, n, m_rxModem);
+
+    m_rxBuffer.put(reinterpret_cast<const uint16_t*>(m_rxModem), NULL, rssi, len);
+
+    if (len > 0U)
+        m_dspEvent.signal();
+}
+
+void CIO::floatToQ15(const float* in, q15_t* out, uint16_t length)
+{
+    for (uint16_t i = 0U; i < length; i++) {
+        float v = in[i] * 32768.0F;
+        v = v >  32767.0F ?  32767.0F : v;
+        v = v < -32768.0F ? -32768.0F : v;
+        out[i] = q15_t(v);
     }
-    m_rxFrac = acc;
-    ::pthread_mutex_unlock(&m_RXlock);
-    return;
 }
 
 bool CIO::getCOSInt()
@@ -124,8 +124,8 @@ void loop()
 
   if (m_modemState == STATE_IDLE)
     cwIdTX.process();
-  
-  usleep(20);
+
+  io.wait(serial.getFd());
 }
 
 int main()
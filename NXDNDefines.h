@@ -20,15 +20,16 @@
 #define  NXDNDEFINES_H
 
 const unsigned int NXDN_RADIO_SYMBOL_LENGTH = 10U;      // At 24 kHz sample rate
+const unsigned int NXDN_RX_SYMBOL_LENGTH    = RX_4FSK_SYMBOL_LENGTH;   // After the RX decimator
 
 const unsigned int NXDN_FRAME_LENGTH_BITS    = 384U;
 const unsigned int NXDN_FRAME_LENGTH_BYTES   = NXDN_FRAME_LENGTH_BITS / 8U;
 const unsigned int NXDN_FRAME_LENGTH_SYMBOLS = NXDN_FRAME_LENGTH_BITS / 2U;
-const unsigned int NXDN_FRAME_LENGTH_SAMPLES = NXDN_FRAME_LENGTH_SYMBOLS * NXDN_RADIO_SYMBOL_LENGTH;
+const unsigned int NXDN_FRAME_LENGTH_SAMPLES = NXDN_FRAME_LENGTH_SYMBOLS * NXDN_RX_SYMBOL_LENGTH;
 
 const unsigned int NXDN_FSW_LENGTH_BITS    = 20U;
 const unsigned int NXDN_FSW_LENGTH_SYMBOLS = NXDN_FSW_LENGTH_BITS / 2U;
-const unsigned int NXDN_FSW_LENGTH_SAMPLES = NXDN_FSW_LENGTH_SYMBOLS * NXDN_RADIO_SYMBOL_LENGTH;
+const unsigned int NXDN_FSW_LENGTH_SAMPLES = NXDN_FSW_LENGTH_SYMBOLS * NXDN_RX_SYMBOL_LENGTH;
 
 const uint8_t NXDN_FSW_BYTES[]      = {0xCDU, 0xF5U, 0x90U};
 const uint8_t NXDN_FSW_BYTES_MASK[] = {0xFFU, 0xFFU, 0xF0U};
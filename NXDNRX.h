@@ -21,49 +21,31 @@
 
 #include "Config.h"
 #include "NXDNDefines.h"
-
-enum NXDNRX_STATE {
-  NXDNRXS_NONE,
-  NXDNRXS_DATA
+#include "4FSKRX.h"
+
+struct NXDNRX_TRAITS {
+  static constexpr const char*   NAME                    = "NXDNRX";
+  static constexpr uint16_t      BUFFER_LENGTH           = NXDN_FRAME_LENGTH_SYMBOLS;
+  static constexpr uint16_t      SYMBOL_LENGTH           = 1U;
+  static constexpr uint16_t      FRAME_LENGTH_BYTES      = NXDN_FRAME_LENGTH_BYTES;
+  static constexpr const int8_t* SYNC_SYMBOLS_VALUES     = NXDN_FSW_SYMBOLS_VALUES;
+  static constexpr uint16_t      SYNC_LENGTH_SYMBOLS     = NXDN_FSW_LENGTH_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS            = NXDN_FSW_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS_MASK       = NXDN_FSW_SYMBOLS_MASK;
+  static constexpr uint64_t      SYNC_BITS               = NXDN_FSW_BITS;
+  static constexpr uint64_t      SYNC_BITS_MASK          = NXDN_FSW_BITS_MASK;
+  static constexpr uint8_t       MAX_SYNC_SYMBOLS_ERRS   = 2U;
+  static constexpr uint8_t       MAX_SYNC_BIT_START_ERRS = 1U;
+  static constexpr uint8_t       MAX_SYNC_BIT_RUN_ERRS   = 3U;
+  static constexpr uint16_t      MAX_SYNC_FRAMES         = 5U + 1U;
+  static constexpr q15_t         SCALING_FACTOR          = 18750;      // Q15(0.55)
+  static constexpr uint8_t       AVERAGE_SHIFT           = 4U;
+
+  static void writeData(const uint8_t* data, uint8_t length);
+  static void writeLost();
 };
 
-class CNXDNRX {
-public:
-  CNXDNRX();
-
-  void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
-
-  void reset();
-
-private:
-  NXDNRX_STATE m_state;
-  uint16_t     m_bitBuffer[NXDN_RADIO_SYMBOL_LENGTH];
-  q15_t        m_buffer[NXDN_FRAME_LENGTH_SAMPLES];
-  uint16_t     m_bitPtr;
-  uint16_t     m_dataPtr;
-  uint16_t     m_startPtr;
-  uint16_t     m_endPtr;
-  uint16_t     m_fswPtr;
-  uint16_t     m_minFSWPtr;
-  uint16_t     m_maxFSWPtr;
-  q31_t        m_maxCorr;
-  uint16_t     m_lostCount;
-  uint8_t      m_countdown;
-  q15_t        m_centre[16U];
-  q15_t        m_centreVal;
-  q15_t        m_threshold[16U];
-  q15_t        m_thresholdVal;
-  uint8_t      m_averagePtr;
-  uint32_t     m_rssiAccum;
-  uint16_t     m_rssiCount;
-
-  void processNone(q15_t sample);
-  void processData(q15_t sample);
-  bool correlateFSW();
-  void calculateLevels(uint16_t start, uint16_t count);
-  void samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold);
-  void writeRSSIData(uint8_t* data);
-};
+typedef C4FSKFrameRX<NXDNRX_TRAITS> CNXDNRX;
 
 #endif
 
@@ -20,6 +20,9 @@
 #define  NXDNTX_H
 
 #include "Config.h"
+#include "NXDNDefines.h"
+#include "4FSKTX.h"
+#include "TXCache.h"
 
 #include "SerialRB.h"
 
@@ -36,17 +39,17 @@ public:
   uint8_t getSpace() const;
 
 private:
-  CSerialRB                        m_buffer;
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  arm_fir_instance_q15             m_sincFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
-  q15_t                            m_sincState[70U];   // NoTaps + BlockSize - 1, 22 + 40 - 1 plus some spare
-  uint8_t                          m_poBuffer[1200U];
-  uint16_t                         m_poLen;
-  uint16_t                         m_poPtr;
-  uint16_t                         m_txDelay;
-
-  void writeByte(uint8_t c);
+  CSerialRB                         m_buffer;
+  C4FSKTX<NXDN_RADIO_SYMBOL_LENGTH> m_modulator;
+  CTXCache                          m_syncCache;
+  arm_fir_instance_q15              m_sincFilter;
+  q15_t                             m_sincState[670U];  // NoTaps + BlockSize - 1, 22 + 640 - 1 plus some spare
+  uint8_t                           m_poBuffer[1200U];
+  uint16_t                          m_poLen;
+  uint16_t                          m_poPtr;
+  uint16_t                          m_txDelay;
+
+  void writeBytes(const uint8_t* data, uint16_t length);
 };
 
 #endif
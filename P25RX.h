@@ -21,6 +21,22 @@
 
 #include "Config.h"
 #include "P25Defines.h"
+#include "4FSKRX.h"
+
+struct P25RX_TRAITS {
+  static constexpr const char*   NAME                  = "P25RX";
+  static constexpr uint16_t      BUFFER_LENGTH         = P25_LDU_FRAME_LENGTH_SYMBOLS;
+  static constexpr uint16_t      SYMBOL_LENGTH         = 1U;
+  static constexpr const int8_t* SYNC_SYMBOLS_VALUES   = P25_SYNC_SYMBOLS_VALUES;
+  static constexpr uint16_t      SYNC_LENGTH_SYMBOLS   = P25_SYNC_LENGTH_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS          = P25_SYNC_SYMBOLS;
+  static constexpr uint32_t      SYNC_SYMBOLS_MASK     = P25_SYNC_SYMBOLS_MASK;
+  static constexpr uint64_t      SYNC_BITS             = P25_SYNC_BITS;
+  static constexpr uint64_t      SYNC_BITS_MASK        = P25_SYNC_BITS_MASK;
+  static constexpr uint8_t       MAX_SYNC_SYMBOLS_ERRS = 2U;
+  static constexpr q15_t         SCALING_FACTOR        = 18750;      // Q15(0.57)
+  static constexpr uint8_t       AVERAGE_SHIFT         = 4U;
+};
 
 enum P25RX_STATE {
   P25RXS_NONE,
@@ -28,20 +44,17 @@ enum P25RX_STATE {
   P25RXS_LDU
 };
 
-class CP25RX {
+class CP25RX : public C4FSKRX<P25RX_TRAITS> {
 public:
   CP25RX();
 
-  void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
+  // Takes one value per symbol, at the symbol centre found by CSymbolTiming
+  void samples(const q15_t* samples, const uint16_t* rssi, uint16_t length);
 
   void reset();
 
 private:
   P25RX_STATE m_state;
-  uint32_t    m_bitBuffer[P25_RADIO_SYMBOL_LENGTH];
-  q15_t       m_buffer[P25_LDU_FRAME_LENGTH_SAMPLES];
-  uint16_t    m_bitPtr;
-  uint16_t    m_dataPtr;
   uint16_t    m_hdrStartPtr;
   uint16_t    m_lduStartPtr;
   uint16_t    m_lduEndPtr;
@@ -52,20 +65,11 @@ private:
   q31_t       m_maxCorr;
   uint16_t    m_lostCount;
   uint8_t     m_countdown;
-  q15_t       m_centre[16U];
-  q15_t       m_centreVal;
-  q15_t       m_threshold[16U];
-  q15_t       m_thresholdVal;
-  uint8_t     m_averagePtr;
-  uint32_t    m_rssiAccum;
-  uint16_t    m_rssiCount;
 
-  void processNone(q15_t sample);
-  void processHdr(q15_t sample);
-  void processLdu(q15_t sample);
+  void processNone();
+  void processHdr();
+  void processLdu();
   bool correlateSync();
-  void calculateLevels(uint16_t start, uint16_t count);
-  void samplesToBits(uint16_t start, uint16_t count, uint8_t* buffer, uint16_t offset, q15_t centre, q15_t threshold);
   void writeRSSILdu(uint8_t* ldu);
 };
 
@@ -22,48 +22,26 @@
 #include "P25TX.h"
 
 #include "P25Defines.h"
-
-// Generated using rcosdesign(0.2, 8, 5, 'normal') in MATLAB
-// numTaps = 40, L = 5
-static q15_t RC_0_2_FILTER[] = {-897, -1636, -1840, -1278, 0, 1613, 2936, 3310, 2315, 0, -3011, -5627, -6580, -4839,
-                                0, 7482, 16311, 24651, 30607, 32767, 30607, 24651, 16311, 7482, 0, -4839, -6580, -5627,
-                               -3011, 0, 2315, 3310, 2936, 1613, 0, -1278, -1840, -1636, -897, 0}; // numTaps = 40, L = 5
-const uint16_t RC_0_2_FILTER_PHASE_LEN = 8U; // phaseLength = numTaps/L
-
-static q15_t LOWPASS_FILTER[] = {124, -188, -682, 1262, 556, -621, -1912, -911, 2058, 3855, 1234, -4592, -7692, -2799,
-                                8556, 18133, 18133, 8556, -2799, -7692, -4592, 1234, 3855, 2058, -911, -1912, -621,
-                                556, 1262, -682, -188, 124};
-const uint16_t LOWPASS_FILTER_LEN = 32U;
-
-const q15_t P25_LEVELA =  1260;
-const q15_t P25_LEVELB =   420;
-const q15_t P25_LEVELC =  -420;
-const q15_t P25_LEVELD = -1260;
+#include "TXFilters.h"
 
 const uint8_t P25_START_SYNC = 0x77U;
 
 CP25TX::CP25TX() :
 m_buffer(1500U),
-m_modFilter(),
+m_modulator(P25_MOD_TABLE.data()),
+m_syncCache(STATE_P25, P25_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES),
 m_lpFilter(),
-m_modState(),
 m_lpState(),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
 m_txDelay(240U)       // 200ms
 {
-  ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-  ::memset(m_lpState,  0x00U, 60U * sizeof(q15_t));
-
-  m_modFilter.L           = P25_RADIO_SYMBOL_LENGTH;
-  m_modFilter.phaseLength = RC_0_2_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = RC_0_2_FILTER;
-  m_modFilter.pState      = m_modState;
+  ::memset(m_lpState, 0x00U, 360U * sizeof(q15_t));
 
-  m_lpFilter.numTaps = LOWPASS_FILTER_LEN;
+  m_lpFilter.numTaps = P25_LOWPASS_FILTER_LEN;
   m_lpFilter.pState  = m_lpState;
-  m_lpFilter.pCoeffs = LOWPASS_FILTER;
+  m_lpFilter.pCoeffs = P25_LOWPASS_FILTER;
 }
 
 void CP25TX::process()
@@ -87,19 +65,16 @@ void CP25TX::process()
   }
 
   if (m_poLen > 0U) {
-    uint16_t space = io.getSpace();
-    
-    while (space > (4U * P25_RADIO_SYMBOL_LENGTH)) {
-      uint8_t c = m_poBuffer[m_poPtr++];
-      writeByte(c);
-
-      space -= 4U * P25_RADIO_SYMBOL_LENGTH;
-      
-      if (m_poPtr >= m_poLen) {
-        m_poPtr = 0U;
-        m_poLen = 0U;
-        return;
-      }
+    uint16_t count = C4FSKTX<P25_RADIO_SYMBOL_LENGTH>::getBytes(io.getSpace());
+    if (count > (m_poLen - m_poPtr))
+      count = m_poLen - m_poPtr;
+
+    writeBytes(m_poBuffer + m_poPtr, count);
+    m_poPtr += count;
+
+    if (m_poPtr >= m_poLen) {
+      m_poPtr = 0U;
+      m_poLen = 0U;
     }
   }
 }
@@ -120,36 +95,34 @@ uint8_t CP25TX::writeData(const uint8_t* data, uint8_t length)
   return 0U;
 }
 
-void CP25TX::writeByte(uint8_t c)
+void CP25TX::writeBytes(const uint8_t* data, uint16_t length)
 {
-  q15_t inBuffer[4U];
-  q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-  q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-
-  const uint8_t MASK = 0xC0U;
-
-  for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-    switch (c & MASK) {
-      case 0xC0U:
-        inBuffer[i] = P25_LEVELA;
-        break;
-      case 0x80U:
-        inBuffer[i] = P25_LEVELB;
-        break;
-      case 0x00U:
-        inBuffer[i] = P25_LEVELC;
-        break;
-      default:
-        inBuffer[i] = P25_LEVELD;
-        break;
-    }
-  }
+  q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
+  q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
+
+  while (length > 0U) {
+    uint16_t n = length > TX_4FSK_BLOCK_BYTES ? TX_4FSK_BLOCK_BYTES : length;
+
+    // Once the modulator has settled on the start sync its bytes are all the same, filtered too
+    uint16_t run = m_modulator.getRun(P25_START_SYNC, data, n);
+    uint16_t cached = m_syncCache.getLength() / (P25_RADIO_SYMBOL_LENGTH * 4U);
+    if (run > 0U && cached > 0U) {
+      n = run < cached ? run : cached;
+      m_syncCache.write(0U, P25_RADIO_SYMBOL_LENGTH * 4U * n);
+    } else {
+      m_modulator.modulate(data, n, intBuffer);
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+      ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U * n);
 
-  ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+      if (run == n)
+        m_syncCache.store(outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U * n);
 
-  io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+      io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U * n);
+    }
+
+    data   += n;
+    length -= n;
+  }
 }
 
 void CP25TX::setTXDelay(uint8_t delay)
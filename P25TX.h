@@ -20,6 +20,9 @@
 #define  P25TX_H
 
 #include "Config.h"
+#include "P25Defines.h"
+#include "4FSKTX.h"
+#include "TXCache.h"
 
 #include "SerialRB.h"
 
@@ -37,16 +40,16 @@ public:
 
 private:
   CSerialRB                        m_buffer;
-  arm_fir_interpolate_instance_q15 m_modFilter;
+  C4FSKTX<P25_RADIO_SYMBOL_LENGTH> m_modulator;
+  CTXCache                         m_syncCache;
   arm_fir_instance_q15             m_lpFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
-  q15_t                            m_lpState[60U];     // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
+  q15_t                            m_lpState[360U];    // NoTaps + BlockSize - 1, 32 + 320 - 1 plus some spare
   uint8_t                          m_poBuffer[1200U];
   uint16_t                         m_poLen;
   uint16_t                         m_poPtr;
   uint16_t                         m_txDelay;
 
-  void writeByte(uint8_t c);
+  void writeBytes(const uint8_t* data, uint16_t length);
 };
 
 #endif
@@ -0,0 +1,64 @@
+/*
+ *   Coefficient tables of the RX filters
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(RXFILTERS_H)
+#define  RXFILTERS_H
+
+#include "Globals.h"
+#include "FilterDesign.h"
+#include "FusedFIR.h"
+
+// Generated using [b, a] = butter(1, 0.001) in MATLAB
+static const q31_t DC_FILTER[] = {3367972, 0, 3367972, 0, 2140747704, 0}; // {b0, 0, b1, b2, -a1, -a2}
+const uint32_t DC_FILTER_STAGES = 1U; // One Biquad stage
+
+// Samples per symbol of the 4800 and 2400 baud modes at the modem sample rate
+const uint16_t SPS_4800 = MODEM_SAMPLE_RATE / 4800U;
+const uint16_t SPS_2400 = MODEM_SAMPLE_RATE / 2400U;
+
+// rcosdesign(0.2, 8, SPS_4800, 'sqrt') with a trailing zero to make the length even
+const uint16_t RRC_0_2_FILTER_LEN = 8U * SPS_4800 + 2U;
+static constexpr auto RRC_0_2_FILTER = rxTaps<RRC_0_2_FILTER_LEN>(designRRC<8U, SPS_4800>(0.2), 32768.0);
+
+// x / sin(x) equaliser for the 2400 baud NXDN symbols at 24 kHz. The design it came from was not
+// recorded, so unlike the other tables it is kept as it was entered.
+const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
+static constexpr std::array<int16_t, NXDN_ISINC_FILTER_LEN> NXDN_ISINC_FILTER = {790, -1085, -1073, -553, 747, 2341, 3156, 2152, -893, -4915, -7834, -7536, -3102, 4441, 12354, 17394, 17394,
+                                                                                 12354, 4441, -3102, -7536, -7834, -4915, -893, 2152, 3156, 2341, 747, -553, -1073, -1085, 790};
+static_assert(MODEM_SAMPLE_RATE == 24000U, "the NXDN ISinc table is for a 24 kHz modem sample rate");
+
+// rcosdesign(0.2, 8, SPS_2400, 'sqrt') with a trailing zero to make the length even
+const uint16_t NXDN_0_2_FILTER_LEN = 8U * SPS_2400 + 2U;
+static constexpr auto NXDN_0_2_FILTER = rxTaps<NXDN_0_2_FILTER_LEN>(designRRC<8U, SPS_2400>(0.2), 32768.0);
+
+// The NXDN RRC convolved with the NXDN ISinc filter and given a leading zero to make the length
+// even. One pass replaces the two cascaded filters and keeps their delay.
+const uint16_t NXDN_0_2_ISINC_FILTER_LEN = NXDN_0_2_FILTER_LEN + NXDN_ISINC_FILTER_LEN;
+static constexpr auto NXDN_0_2_ISINC_FILTER = cascadeTaps<NXDN_0_2_ISINC_FILTER_LEN>(NXDN_0_2_FILTER, NXDN_ISINC_FILTER);
+
+// gaussfir(0.5, 4, SPS_4800) cut to the centre two symbols with a trailing zero
+const uint16_t GAUSSIAN_0_5_FILTER_LEN = 2U * SPS_4800 + 2U;
+static constexpr auto GAUSSIAN_0_5_FILTER = rxTaps<GAUSSIAN_0_5_FILTER_LEN>(designGaussian<4U, SPS_4800>(0.5), 32768.0);
+
+static_assert(NXDN_0_2_ISINC_FILTER_LEN <= FUSED_FIR_MAX_TAPS, "the RX filters do not fit the fused FIR");
+
+// One symbol boxcar filter
+static const q15_t BOXCAR_FILTER[] = {12000, 12000, 12000, 12000, 12000, 0};
+const uint16_t BOXCAR_FILTER_LEN = 6U;
+
+#endif
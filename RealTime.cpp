@@ -0,0 +1,157 @@
+/*
+ *   Real-time scheduling profile for the modem threads
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "RealTime.h"
+
+#include "Log.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Set by RTLockMemory before the other threads start, prefaulting a stack that can still be paged
+// out buys nothing
+static bool memoryLocked = false;
+
+CRTProfile::CRTProfile(const char* name) :
+m_name(name),
+m_policy(SCHED_OTHER),
+m_priority(0),
+m_cpus(),
+m_pinned(false)
+{
+  CPU_ZERO(&m_cpus);
+}
+
+void CRTProfile::load()
+{
+  char var[40U];
+
+  // A priority of zero keeps the thread in the normal time sharing class
+  ::snprintf(var, sizeof(var), "RT_%s_PRIORITY", m_name);
+  const char* priority = ::getenv(var);
+  if (priority != NULL)
+    m_priority = ::atoi(priority);
+
+  if (m_priority > 0) {
+    const char* policy = ::getenv("RT_POLICY");
+    m_policy = (policy != NULL && ::strcmp(policy, "RR") == 0) ? SCHED_RR : SCHED_FIFO;
+
+    int min = ::sched_get_priority_min(m_policy);
+    int max = ::sched_get_priority_max(m_policy);
+    if (m_priority < min)
+      m_priority = min;
+    if (m_priority > max)
+      m_priority = max;
+  }
+
+  // A CPU list such as "2,3" or "2-3"
+  ::snprintf(var, sizeof(var), "RT_%s_CPUS", m_name);
+  const char* cpus = ::getenv(var);
+  if (cpus != NULL) {
+    const char* p = cpus;
+    while (*p != '\0') {
+      char* end = NULL;
+      long first = ::strtol(p, &end, 10);
+      if (end == p)
+        break;
+
+      long last = first;
+      if (*end == '-') {
+        p = end + 1;
+        last = ::strtol(p, &end, 10);
+        if (end == p)
+          break;
+      }
+
+      for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+        if (cpu >= 0) {
+          CPU_SET(cpu, &m_cpus);
+          m_pinned = true;
+        }
+      }
+
+      p = (*end == ',') ? end + 1 : end;
+    }
+
+    if (!m_pinned)
+      LogWarning("%s thread: cannot parse CPU list \"%s\"", m_name, cpus);
+  }
+}
+
+void CRTProfile::apply() const
+{
+  if (m_priority > 0) {
+    struct sched_param param;
+    ::memset(&param, 0x00U, sizeof(param));
+    param.sched_priority = m_priority;
+
+    int err = ::pthread_setschedparam(::pthread_self(), m_policy, &param);
+    if (err == 0)
+      LogMessage("%s thread: %s priority %d", m_name, m_policy == SCHED_RR ? "SCHED_RR" : "SCHED_FIFO", m_priority);
+    else
+      LogWarning("%s thread: cannot set real-time priority %d, error %d, staying at SCHED_OTHER", m_name, m_priority, err);
+  }
+
+  if (m_pinned) {
+    int err = ::pthread_setaffinity_np(::pthread_self(), sizeof(m_cpus), &m_cpus);
+    if (err == 0) {
+      char list[100U];
+      unsigned int len = 0U;
+      list[0U] = '\0';
+      for (int cpu = 0; cpu < CPU_SETSIZE && len < sizeof(list) - 5U; cpu++) {
+        if (CPU_ISSET(cpu, &m_cpus))
+          len += ::snprintf(list + len, sizeof(list) - len, len == 0U ? "%d" : ",%d", cpu);
+      }
+
+      LogMessage("%s thread: pinned to CPU %s", m_name, list);
+    } else {
+      LogWarning("%s thread: cannot set CPU affinity, error %d, running on any CPU", m_name, err);
+    }
+  }
+
+  if (memoryLocked)
+    RTPrefaultStack();
+}
+
+void RTLockMemory()
+{
+  const char* mlock = ::getenv("RT_MLOCK");
+  if (mlock == NULL || ::atoi(mlock) == 0)
+    return;
+
+  if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+    LogMessage("Memory locked");
+    memoryLocked = true;
+  } else {
+    LogWarning("Cannot lock memory, errno=%d, pages may be swapped or faulted in late", errno);
+  }
+}
+
+void RTPrefaultStack()
+{
+  unsigned char stack[RT_STACK_PREFAULT];
+
+  // A store through a volatile pointer is kept, one per page is enough
+  volatile unsigned char* page = stack;
+  for (unsigned int i = 0U; i < RT_STACK_PREFAULT; i += 4096U)
+    page[i] = 0U;
+}
@@ -0,0 +1,55 @@
+/*
+ *   Real-time scheduling profile for the modem threads
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(REALTIME_H)
+#define  REALTIME_H
+
+#include <sched.h>
+
+// Bytes of stack touched by each thread at start-up so it is resident before it's needed
+const unsigned int RT_STACK_PREFAULT = 256U * 1024U;
+
+// Scheduling settings for one thread, read from RT_<NAME>_PRIORITY and RT_<NAME>_CPUS
+// together with the process wide RT_POLICY
+class CRTProfile {
+public:
+  CRTProfile(const char* name);
+
+  void load();
+
+  // Applies the profile to the calling thread and, once RTLockMemory has locked the memory,
+  // prefaults its stack. Anything the system refuses is logged and left at its default, the
+  // thread carries on either way.
+  void apply() const;
+
+private:
+  const char* m_name;
+  int         m_policy;
+  int         m_priority;
+  cpu_set_t   m_cpus;
+  bool        m_pinned;
+};
+
+// Locks current and future pages into RAM when RT_MLOCK is set, before the profiles are applied
+extern void RTLockMemory();
+
+// Touches RT_STACK_PREFAULT bytes of the calling thread's stack, apply does this already when
+// the memory is locked
+extern void RTPrefaultStack();
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ *   Fixed point polyphase rational resampler
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Resampler.h"
+
+#include <cmath>
+
+// Transition width of a Blackman window is about 5.5 / N of the sample rate
+const double BLACKMAN_TRANSITION = 5.5;
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+  while (b != 0U) {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+
+  return a;
+}
+
+CResampler::CResampler() :
+m_l(1U),
+m_m(1U),
+m_taps(0U),
+m_coeffs(NULL),
+m_state(NULL),
+m_phase(0U)
+{
+}
+
+CResampler::~CResampler()
+{
+  delete[] m_coeffs;
+  delete[] m_state;
+}
+
+bool CResampler::setRates(uint32_t inRate, uint32_t outRate)
+{
+  if (inRate == 0U || outRate == 0U)
+    return false;
+
+  uint32_t div = gcd(inRate, outRate);
+  uint32_t l   = outRate / div;
+  uint32_t m   = inRate / div;
+
+  if (l > RESAMPLER_MAX_PHASES || m > 65535U)
+    return false;
+
+  delete[] m_coeffs;
+  delete[] m_state;
+  m_coeffs = NULL;
+  m_state  = NULL;
+
+  m_l     = uint16_t(l);
+  m_m     = uint16_t(m);
+  m_taps  = 0U;
+  m_phase = 0U;
+
+  // Equal rates pass straight through
+  if (m_l == 1U && m_m == 1U)
+    return true;
+
+  // The cut-off sits at half the lower rate, with the stop band starting at three quarters
+  // of it. Anything aliased into the transition band lands above the modem's own filters.
+  double minRate    = double(inRate < outRate ? inRate : outRate);
+  double cutoff     = 0.5 * minRate;
+  double transition = 0.5 * minRate;
+
+  uint32_t taps = uint32_t(::ceil(BLACKMAN_TRANSITION * double(inRate) / transition));
+  taps = (taps + 1U) & ~1U;
+  if (taps > RESAMPLER_MAX_TAPS)
+    taps = RESAMPLER_MAX_TAPS;
+  m_taps = uint16_t(taps);
+
+  // Prototype low pass at the interpolated rate with a gain of L, so each branch has unity gain
+  uint32_t len    = uint32_t(m_l) * m_taps;
+  double   upRate = double(inRate) * double(m_l);
+  double   fc     = cutoff / upRate;
+  double   centre = double(len - 1U) / 2.0;
+
+  double* proto = new double[len];
+  for (uint32_t n = 0U; n < len; n++) {
+    double x    = double(n) - centre;
+    double sinc = (x == 0.0) ? 1.0 : ::sin(2.0 * M_PI * fc * x) / (2.0 * M_PI * fc * x);
+    double w    = 0.42 - 0.5 * ::cos(2.0 * M_PI * double(n) / double(len - 1U)) + 0.08 * ::cos(4.0 * M_PI * double(n) / double(len - 1U));
+
+    proto[n] = double(m_l) * 2.0 * fc * sinc * w;
+  }
+
+  // Split into branches, reversed into state order so each output is a straight dot product
+  m_coeffs = new q15_t[len];
+  for (uint16_t p = 0U; p < m_l; p++) {
+    double absSum = 0.0;
+    for (uint16_t k = 0U; k < m_taps; k++)
+      absSum += ::fabs(proto[p + k * m_l]);
+
+    // Keep the worst case q31 accumulation inside its range
+    double scale = absSum > 1.99 ? 1.99 / absSum : 1.0;
+
+    for (uint16_t k = 0U; k < m_taps; k++) {
+      long v = ::lround(proto[p + k * m_l] * scale * 32768.0);
+      if (v > 32767)
+        v = 32767;
+      if (v < -32768)
+        v = -32768;
+
+      m_coeffs[p * m_taps + (m_taps - 1U - k)] = q15_t(v);
+    }
+  }
+
+  delete[] proto;
+
+  m_state = new q15_t[m_taps - 1U + RESAMPLER_BLOCK_SIZE];
+  ::memset(m_state, 0x00U, (m_taps - 1U + RESAMPLER_BLOCK_SIZE) * sizeof(q15_t));
+
+  return true;
+}
+
+void CResampler::reset()
+{
+  m_phase = 0U;
+
+  if (m_state != NULL)
+    ::memset(m_state, 0x00U, (m_taps - 1U + RESAMPLER_BLOCK_SIZE) * sizeof(q15_t));
+}
+
+uint16_t CResampler::getMaxInput(uint16_t outSpace) const
+{
+  if (outSpace == 0U)
+    return 0U;
+
+  // n inputs span n * L interpolated samples, which hold at most n * L / M + 1 outputs
+  uint32_t n = (uint32_t(outSpace - 1U) * m_m) / m_l;
+
+  return n > 65535U ? 65535U : uint16_t(n);
+}
+
+uint16_t CResampler::process(const q15_t* in, uint16_t length, q15_t* out)
+{
+  if (m_coeffs == NULL) {
+    ::memcpy(out, in, length * sizeof(q15_t));
+    return length;
+  }
+
+  uint16_t total = 0U;
+
+  while (length > 0U) {
+    uint16_t n = length > RESAMPLER_BLOCK_SIZE ? RESAMPLER_BLOCK_SIZE : length;
+
+    total += processBlock(in, n, out + total);
+
+    in     += n;
+    length -= n;
+  }
+
+  return total;
+}
+
+uint16_t CResampler::processBlock(const q15_t* in, uint16_t length, q15_t* out)
+{
+  q15_t* history = m_state + m_taps - 1U;
+  ::memcpy(history, in, length * sizeof(q15_t));
+
+  uint16_t n = 0U;
+
+  for (uint16_t i = 0U; i < length; i++) {
+    const q15_t* x = m_state + i;
+
+    while (m_phase < m_l) {
+      const q15_t* c = m_coeffs + m_phase * m_taps;
+
+      q31_t acc = 0;
+      for (uint16_t k = 0U; k < m_taps; k++)
+        acc += q31_t(x[k]) * c[k];
+
+      acc = (acc + 0x4000) >> 15;
+      out[n++] = q15_t(__SSAT(acc, 16));
+
+      m_phase += m_m;
+    }
+
+    m_phase -= m_l;
+  }
+
+  // Keep the last taps - 1 samples for the next call
+  ::memmove(m_state, m_state + length, (m_taps - 1U) * sizeof(q15_t));
+
+  return n;
+}
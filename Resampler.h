@@ -0,0 +1,63 @@
+/*
+ *   Fixed point polyphase rational resampler
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(RESAMPLER_H)
+#define  RESAMPLER_H
+
+#include "Globals.h"
+
+// Limits on the interpolation factor and the taps per polyphase branch
+const uint16_t RESAMPLER_MAX_PHASES = 512U;
+const uint16_t RESAMPLER_MAX_TAPS   = 256U;
+
+// Largest input block handled in one pass, longer blocks are split internally
+const uint16_t RESAMPLER_BLOCK_SIZE = 512U;
+
+class CResampler {
+public:
+  CResampler();
+  ~CResampler();
+
+  // Designs the anti-alias/anti-image filter for inRate -> outRate, the ratio is reduced
+  // to L/M. Returns false if L or the filter length would exceed the limits above.
+  bool setRates(uint32_t inRate, uint32_t outRate);
+
+  void reset();
+
+  // The largest input block that can't produce more than outSpace output samples
+  uint16_t getMaxInput(uint16_t outSpace) const;
+
+  // Returns the number of output samples written
+  uint16_t process(const q15_t* in, uint16_t length, q15_t* out);
+
+  uint16_t getInterpolation() const { return m_l; }
+  uint16_t getDecimation() const { return m_m; }
+  uint16_t getTaps() const { return m_taps; }
+
+private:
+  uint16_t m_l;
+  uint16_t m_m;
+  uint16_t m_taps;
+  q15_t*   m_coeffs;      // m_l branches of m_taps, each in state order
+  q15_t*   m_state;       // m_taps - 1 history samples plus one input block
+  uint32_t m_phase;
+
+  uint16_t processBlock(const q15_t* in, uint16_t length, q15_t* out);
+};
+
+#endif
@@ -20,89 +20,144 @@ Boston, MA  02110-1301, USA.
 
 #include "SampleRB.h"
 
+#include <cstring>
+
 CSampleRB::CSampleRB(uint16_t length) :
-m_length(length),
+m_length(1U),
+m_mask(0U),
 m_samples(NULL),
 m_control(NULL),
+m_rssi(NULL),
+m_overflow(false),
 m_head(0U),
+m_tailCache(0U),
 m_tail(0U),
-m_full(false),
-m_overflow(false)
+m_headCache(0U)
 {
-  m_samples = new uint16_t[length];
-  m_control = new uint8_t[length];
+  while (m_length < length)
+    m_length <<= 1;
+  m_mask = m_length - 1U;
+
+  m_samples = new uint16_t[m_length];
+  m_control = new uint8_t[m_length];
+  m_rssi    = new uint16_t[m_length];
 }
 
-uint16_t CSampleRB::getSpace() const
+CSampleRB::~CSampleRB()
 {
-  uint16_t n = 0U;
-
-  if (m_tail == m_head)
-    n = m_full ? 0U : m_length;
-  else if (m_tail < m_head)
-    n = m_length - m_head + m_tail;
-  else
-    n = m_tail - m_head;
+  delete[] m_samples;
+  delete[] m_control;
+  delete[] m_rssi;
+}
 
-  if (n > m_length)
-    n = 0U;
+uint16_t CSampleRB::getSpace() const
+{
+  uint32_t tail = m_tail.load(std::memory_order_acquire);
+  uint32_t head = m_head.load(std::memory_order_acquire);
 
-  return n;
+  return uint16_t(m_length - (head - tail));
 }
 
 uint16_t CSampleRB::getData() const
 {
-  if (m_tail == m_head)
-    return m_full ? m_length : 0U;
-  else if (m_tail < m_head)
-    return m_head - m_tail;
-  else
-    return m_length - m_tail + m_head;
+  uint32_t head = m_head.load(std::memory_order_acquire);
+  uint32_t tail = m_tail.load(std::memory_order_acquire);
+
+  return uint16_t(head - tail);
 }
 
 bool CSampleRB::put(uint16_t sample, uint8_t control)
 {
-  if (m_full) {
-    m_overflow = true;
-    return false;
+  return put(&sample, &control, 0U, 1U) == 1U;
+}
+
+bool CSampleRB::get(uint16_t& sample, uint8_t& control)
+{
+  return get(&sample, &control, NULL, 1U) == 1U;
+}
+
+uint16_t CSampleRB::put(const uint16_t* samples, const uint8_t* control, uint16_t rssi, uint16_t length)
+{
+  uint32_t head = m_head.load(std::memory_order_relaxed);
+
+  // Only go back to the shared tail when the cached one says we're short of room
+  uint32_t space = m_length - (head - m_tailCache);
+  if (space < length) {
+    m_tailCache = m_tail.load(std::memory_order_acquire);
+    space = m_length - (head - m_tailCache);
+  }
+
+  uint32_t n = length;
+  if (n > space) {
+    n = space;
+    m_overflow.store(true, std::memory_order_relaxed);
   }
 
-  m_samples[m_head] = sample;
-  m_control[m_head] = control;
+  // At most two contiguous pieces either side of the wrap
+  uint32_t pos   = head & m_mask;
+  uint32_t first = m_length - pos;
+  if (first > n)
+    first = n;
+
+  ::memcpy(m_samples + pos, samples, first * sizeof(uint16_t));
+  ::memcpy(m_samples, samples + first, (n - first) * sizeof(uint16_t));
+
+  if (control != NULL) {
+    ::memcpy(m_control + pos, control, first);
+    ::memcpy(m_control, control + first, n - first);
+  } else {
+    ::memset(m_control + pos, 0x00U, first);
+    ::memset(m_control, 0x00U, n - first);
+  }
 
-  m_head++;
-  if (m_head >= m_length)
-    m_head = 0U;
+  for (uint32_t i = 0U; i < first; i++)
+    m_rssi[pos + i] = rssi;
+  for (uint32_t i = first; i < n; i++)
+    m_rssi[i - first] = rssi;
 
-  if (m_head == m_tail)
-    m_full = true;
+  m_head.store(head + n, std::memory_order_release);
 
-  return true;
+  return uint16_t(n);
 }
 
-bool CSampleRB::get(uint16_t& sample, uint8_t& control)
+uint16_t CSampleRB::get(uint16_t* samples, uint8_t* control, uint16_t* rssi, uint16_t length)
 {
-  if (m_head == m_tail && !m_full)
-    return false;
+  uint32_t tail = m_tail.load(std::memory_order_relaxed);
 
-  sample  = m_samples[m_tail];
-  control = m_control[m_tail];
+  uint32_t data = m_headCache - tail;
+  if (data < length) {
+    m_headCache = m_head.load(std::memory_order_acquire);
+    data = m_headCache - tail;
+  }
 
-  m_full = false;
+  uint32_t n = length;
+  if (n > data)
+    n = data;
 
-  m_tail++;
-  if (m_tail >= m_length)
-    m_tail = 0U;
+  uint32_t pos   = tail & m_mask;
+  uint32_t first = m_length - pos;
+  if (first > n)
+    first = n;
 
-  return true;
-}
+  ::memcpy(samples, m_samples + pos, first * sizeof(uint16_t));
+  ::memcpy(samples + first, m_samples, (n - first) * sizeof(uint16_t));
 
-bool CSampleRB::hasOverflowed()
-{
-  bool overflow = m_overflow;
+  if (control != NULL) {
+    ::memcpy(control, m_control + pos, first);
+    ::memcpy(control + first, m_control, n - first);
+  }
+
+  if (rssi != NULL) {
+    ::memcpy(rssi, m_rssi + pos, first * sizeof(uint16_t));
+    ::memcpy(rssi + first, m_rssi, (n - first) * sizeof(uint16_t));
+  }
 
-  m_overflow = false;
+  m_tail.store(tail + n, std::memory_order_release);
 
-  return overflow;
+  return uint16_t(n);
 }
 
+bool CSampleRB::hasOverflowed()
+{
+  return m_overflow.exchange(false, std::memory_order_relaxed);
+}
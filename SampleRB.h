@@ -35,29 +35,52 @@ Boston, MA  02110-1301, USA.
 #include <Arduino.h>
 #endif
 
+#include <atomic>
+
+// Keeps the producer and consumer indices apart so they don't share a cache line
+const size_t RB_CACHE_LINE_SIZE = 64U;
+
+// Lock-free ring for exactly one producer thread and one consumer thread. Each entry
+// carries a sample, its control mark and the RSSI it was received with, held as parallel
+// arrays behind a single index. The length is rounded up to a power of two. getSpace and
+// getData may be called from either thread.
 class CSampleRB {
 public:
   CSampleRB(uint16_t length);
-  
+  ~CSampleRB();
+
   uint16_t getSpace() const;
-  
+
   uint16_t getData() const;
 
   bool put(uint16_t sample, uint8_t control);
 
   bool get(uint16_t& sample, uint8_t& control);
 
+  // Bulk versions, a NULL control block reads as MARK_NONE on put and is skipped on get, as
+  // is a NULL RSSI block on get. The RSSI is measured per block so put takes one value for
+  // the whole span. They return the number of samples moved, a short put counts as an overflow.
+  uint16_t put(const uint16_t* samples, const uint8_t* control, uint16_t rssi, uint16_t length);
+
+  uint16_t get(uint16_t* samples, uint8_t* control, uint16_t* rssi, uint16_t length);
+
   bool hasOverflowed();
 
 private:
-  uint16_t           m_length;
-  volatile uint16_t* m_samples;
-  volatile uint8_t*  m_control;
-  volatile uint16_t  m_head;
-  volatile uint16_t  m_tail;
-  volatile bool      m_full;
-  bool               m_overflow;
+  uint32_t          m_length;
+  uint32_t          m_mask;
+  uint16_t*         m_samples;
+  uint8_t*          m_control;
+  uint16_t*         m_rssi;
+  std::atomic<bool> m_overflow;
+
+  // Written by the producer only
+  alignas(RB_CACHE_LINE_SIZE) std::atomic<uint32_t> m_head;
+  uint32_t                                          m_tailCache;
+
+  // Written by the consumer only
+  alignas(RB_CACHE_LINE_SIZE) std::atomic<uint32_t> m_tail;
+  uint32_t                                          m_headCache;
 };
 
 #endif
-
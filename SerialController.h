@@ -54,6 +54,11 @@ public:
 
 	virtual void close();
 
+#if !defined(_WIN32) && !defined(_WIN64)
+	// For waiting on incoming data alongside other events
+	int getFd() const { return m_fd; }
+#endif
+
 #if defined(__APPLE__)
 	virtual int setNonblock(bool nonblock);
 #endif
@@ -32,6 +32,11 @@ public:
 
   void process();
 
+#if defined(RPI)
+  // The descriptor the host's frames arrive on
+  int getFd() const;
+#endif
+
   void writeDStarHeader(const uint8_t* header, uint8_t length);
   void writeDStarData(const uint8_t* data, uint8_t length);
   void writeDStarLost();
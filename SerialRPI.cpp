@@ -49,6 +49,11 @@ void CSerialPort::beginInt(uint8_t n, int speed)
   }
 }
 
+int CSerialPort::getFd() const
+{
+  return m_controller.getFd();
+}
+
 int CSerialPort::availableInt(uint8_t n)
 {
   switch (n) {
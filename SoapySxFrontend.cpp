@@ -2,11 +2,15 @@
 
 #include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <vector>
 
 SoapySxFrontend::SoapySxFrontend()
     : m_device(nullptr), m_rxStream(nullptr), m_txStream(nullptr),
-      m_centerFreq(446000000.0), m_sampleRate(125000.0), m_rxGain(20.0),
+      m_rxFormatWanted(IQ_AUTO), m_rxFormat(IQ_CF32), m_directAccess(true), m_rxDirect(false), m_txDirect(false), m_rxMTU(0),
+      m_txMTU(0), m_centerFreq(446000000.0), m_sampleRate(125000.0), m_rxGain(20.0),
       m_txGain(0.0) {}
 
 SoapySxFrontend::~SoapySxFrontend() { close(); }
@@ -53,21 +57,62 @@ bool SoapySxFrontend::startRx() {
   if (!m_device && !open())
     return false;
 
-  if (m_rxStream == nullptr)
-    m_rxStream = m_device->setupStream(SOAPY_SDR_RX, SOAPY_SDR_CF32);
+  if (m_rxStream == nullptr) {
+    m_rxFormat = negotiateRxFormat();
+
+    const char *format = SOAPY_SDR_CF32;
+    if (m_rxFormat == IQ_CS16)
+      format = SOAPY_SDR_CS16;
+    else if (m_rxFormat == IQ_CS8)
+      format = SOAPY_SDR_CS8;
+
+    m_rxStream = m_device->setupStream(SOAPY_SDR_RX, format);
+  }
 
   if (m_rxStream == nullptr)
     return false;
 
+  m_rxMTU = m_device->getStreamMTU(m_rxStream);
+  m_rxDirect = m_directAccess && m_device->getNumDirectAccessBuffers(m_rxStream) > 0;
+
   return m_device->activateStream(m_rxStream) == 0;
 }
 
+SX_IQ_FORMAT SoapySxFrontend::negotiateRxFormat() const {
+  std::vector<std::string> formats = m_device->getStreamFormats(SOAPY_SDR_RX, 0);
+  bool hasCS16 = std::find(formats.begin(), formats.end(), SOAPY_SDR_CS16) != formats.end();
+  bool hasCS8 = std::find(formats.begin(), formats.end(), SOAPY_SDR_CS8) != formats.end();
+
+  switch (m_rxFormatWanted) {
+  case IQ_CS16:
+    return hasCS16 ? IQ_CS16 : IQ_CF32;
+  case IQ_CS8:
+    return hasCS8 ? IQ_CS8 : IQ_CF32;
+  case IQ_CF32:
+    return IQ_CF32;
+  default:
+    break;
+  }
+
+  // CS8 loses dynamic range, only take it when that's what the hardware delivers anyway
+  if (hasCS16)
+    return IQ_CS16;
+
+  double fullScale = 0.0;
+  if (hasCS8 && m_device->getNativeStreamFormat(SOAPY_SDR_RX, 0, fullScale) == SOAPY_SDR_CS8)
+    return IQ_CS8;
+
+  return IQ_CF32;
+}
+
 void SoapySxFrontend::stopRx() {
   if (m_device != nullptr && m_rxStream != nullptr) {
     m_device->deactivateStream(m_rxStream);
     m_device->closeStream(m_rxStream);
     m_rxStream = nullptr;
   }
+
+  m_rxDirect = false;
 }
 
 bool SoapySxFrontend::startTx() {
@@ -80,6 +125,9 @@ bool SoapySxFrontend::startTx() {
   if (m_txStream == nullptr)
     return false;
 
+  m_txMTU = m_device->getStreamMTU(m_txStream);
+  m_txDirect = m_directAccess && m_device->getNumDirectAccessBuffers(m_txStream) > 0;
+
   return m_device->activateStream(m_txStream) == 0;
 }
 
@@ -89,9 +137,11 @@ void SoapySxFrontend::stopTx() {
     m_device->closeStream(m_txStream);
     m_txStream = nullptr;
   }
+
+  m_txDirect = false;
 }
 
-int SoapySxFrontend::readIq(std::complex<float> *buf, size_t len,
+int SoapySxFrontend::readIq(void *buf, size_t len,
                              long long *timestamp) {
   if (m_device == nullptr || m_rxStream == nullptr)
     return -1;
@@ -116,3 +166,47 @@ int SoapySxFrontend::writeIq(const std::complex<float> *buf, size_t len,
   return m_device->writeStream(m_txStream, buffs, len, flags, ts, 100000);
 }
 
+
+int SoapySxFrontend::acquireRx(const void *&buf, size_t &handle,
+                                long long *timestamp) {
+  if (m_device == nullptr || m_rxStream == nullptr || !m_rxDirect)
+    return -1;
+
+  const void *buffs[] = {nullptr};
+  int flags = 0;
+  long long ts = 0;
+  int ret = m_device->acquireReadBuffer(m_rxStream, handle, buffs, flags, ts, 100000);
+  if (ret < 0)
+    return ret;
+
+  buf = buffs[0];
+  if (timestamp)
+    *timestamp = ts;
+  return ret;
+}
+
+void SoapySxFrontend::releaseRx(size_t handle) {
+  if (m_device != nullptr && m_rxStream != nullptr)
+    m_device->releaseReadBuffer(m_rxStream, handle);
+}
+
+int SoapySxFrontend::acquireTx(std::complex<float> *&buf, size_t &handle) {
+  if (m_device == nullptr || m_txStream == nullptr || !m_txDirect)
+    return -1;
+
+  void *buffs[] = {nullptr};
+  int ret = m_device->acquireWriteBuffer(m_txStream, handle, buffs, 100000);
+  if (ret < 0)
+    return ret;
+
+  buf = static_cast<std::complex<float> *>(buffs[0]);
+  return ret;
+}
+
+void SoapySxFrontend::releaseTx(size_t handle, size_t len, bool withEOM) {
+  if (m_device == nullptr || m_txStream == nullptr)
+    return;
+
+  int flags = withEOM ? SOAPY_SDR_END_BURST : 0;
+  m_device->releaseWriteBuffer(m_txStream, handle, len, flags, 0);
+}
@@ -2,8 +2,9 @@
  *   SoapySX frontend wrapper for mmdvm-sdr
  *
  *   Provides a thin abstraction around SoapySDR to talk to the SX1255
- *   via the SoapySX driver (driver key: "sx"). IQ is exchanged as
- *   CF32 samples and resampled to the modem's internal rate upstream.
+ *   via the SoapySX driver (driver key: "sx"). RX IQ is exchanged as
+ *   CS16, CS8 or CF32 depending on the driver, TX IQ as CF32, and
+ *   resampled to the modem's internal rate upstream.
  */
 
 #ifndef SOAPY_SX_FRONTEND_H
@@ -14,6 +15,13 @@
 #include <complex>
 #include <cstddef>
 
+enum SX_IQ_FORMAT {
+  IQ_AUTO,
+  IQ_CF32,
+  IQ_CS16,
+  IQ_CS8
+};
+
 class SoapySxFrontend {
 public:
   SoapySxFrontend();
@@ -24,6 +32,8 @@ public:
   void setSampleRate(double sampleRate);
   void setRxGain(double gainDb);
   void setTxGain(double gainDb);
+  // IQ_AUTO prefers CS16, then the driver's native CS8, then CF32
+  void setRxFormat(SX_IQ_FORMAT format) { m_rxFormatWanted = format; }
 
   bool open();
   void close();
@@ -34,22 +44,57 @@ public:
   bool startTx();
   void stopTx();
 
-  // Returns number of complex samples read, or negative on error
-  int readIq(std::complex<float> *buf, size_t len, long long *timestamp = nullptr);
+  // The RX format in use once the stream is started
+  SX_IQ_FORMAT getRxFormat() const { return m_rxFormat; }
+
+  // Reads samples in the RX format. Returns number of complex samples read, or negative on error
+  int readIq(void *buf, size_t len, long long *timestamp = nullptr);
   // Returns number of complex samples written, or negative on error
   int writeIq(const std::complex<float> *buf, size_t len, bool withEOM = false);
 
+  // Direct access to the driver's stream buffers, used in place of readIq/writeIq when
+  // the driver supports it. Must be enabled before the streams are started.
+  void setDirectAccess(bool enable) { m_directAccess = enable; }
+  bool hasRxDirectAccess() const { return m_rxDirect; }
+  bool hasTxDirectAccess() const { return m_txDirect; }
+
+  // Returns the number of complex samples in the acquired RX buffer, or negative on
+  // error. The buffer stays valid until releaseRx is called with the same handle.
+  int acquireRx(const void *&buf, size_t &handle, long long *timestamp = nullptr);
+  void releaseRx(size_t handle);
+
+  // Returns the room in complex samples of the acquired TX buffer, or negative on error.
+  // releaseTx sends the first len samples, zero drops the buffer.
+  int acquireTx(std::complex<float> *&buf, size_t &handle);
+  void releaseTx(size_t handle, size_t len, bool withEOM = false);
+
+  size_t getRxMTU() const { return m_rxMTU; }
+  size_t getTxMTU() const { return m_txMTU; }
+
   double getSampleRate() const { return m_sampleRate; }
 
+  bool isRxRunning() const { return m_rxStream != nullptr; }
+
 private:
   SoapySDR::Device *m_device;
   SoapySDR::Stream *m_rxStream;
   SoapySDR::Stream *m_txStream;
 
+  SX_IQ_FORMAT m_rxFormatWanted;
+  SX_IQ_FORMAT m_rxFormat;
+
+  bool m_directAccess;
+  bool m_rxDirect;
+  bool m_txDirect;
+  size_t m_rxMTU;
+  size_t m_txMTU;
+
   double m_centerFreq;
   double m_sampleRate;
   double m_rxGain;
   double m_txGain;
+
+  SX_IQ_FORMAT negotiateRxFormat() const;
 };
 
 #endif // SOAPY_SX_FRONTEND_H
@@ -0,0 +1,148 @@
+/*
+ *   Fractional decimator for the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "SymbolDecimator.h"
+
+CSymbolDecimator::CSymbolDecimator() :
+m_inLength(1U),
+m_outLength(1U),
+m_position(0U),
+m_control(MARK_NONE),
+m_window()
+{
+}
+
+void CSymbolDecimator::setRatio(uint16_t inLength, uint16_t outLength)
+{
+  m_inLength  = inLength;
+  m_outLength = outLength;
+
+  reset();
+}
+
+void CSymbolDecimator::reset()
+{
+  // The first output sits on the newest sample of the history, which has one older sample
+  // before it for the interpolator
+  m_position = m_outLength;
+  m_control  = MARK_NONE;
+
+  ::memset(m_window, 0x00U, sizeof(m_window));
+}
+
+uint16_t CSymbolDecimator::process(const q15_t* in, const uint16_t* rssi, const uint8_t* control, uint16_t length, q15_t* out, uint16_t* rssiOut, uint8_t* controlOut)
+{
+  // Nothing to do at the same rate, and passing straight through keeps the timing unchanged
+  if (m_inLength == m_outLength) {
+    ::memcpy(out, in, length * sizeof(q15_t));
+    if (rssiOut != NULL)
+      ::memcpy(rssiOut, rssi, length * sizeof(uint16_t));
+    if (controlOut != NULL)
+      ::memcpy(controlOut, control, length * sizeof(uint8_t));
+    return length;
+  }
+
+  uint16_t count = 0U;
+
+  while (length > 0U) {
+    uint16_t n = length > SYMBOL_DECIMATOR_BLOCK_SIZE ? SYMBOL_DECIMATOR_BLOCK_SIZE : length;
+
+    uint16_t m = processBlock(in, rssi, control, n, out + count, rssiOut == NULL ? NULL : rssiOut + count, controlOut == NULL ? NULL : controlOut + count);
+    count += m;
+
+    in     += n;
+    rssi    = rssi == NULL ? NULL : rssi + n;
+    control = control == NULL ? NULL : control + n;
+    length -= n;
+  }
+
+  return count;
+}
+
+uint16_t CSymbolDecimator::processBlock(const q15_t* in, const uint16_t* rssi, const uint8_t* control, uint16_t length, q15_t* out, uint16_t* rssiOut, uint8_t* controlOut)
+{
+  ::memcpy(m_window + SYMBOL_DECIMATOR_HISTORY, in, length * sizeof(q15_t));
+
+  uint16_t count      = 0U;
+  uint16_t controlPtr = 0U;
+
+  // Each output needs the window sample before it and the two after it, the last usable
+  // position is the one before the newest sample
+  for (uint32_t base = m_position / m_outLength; base <= length; base = m_position / m_outLength) {
+    q31_t mu = q31_t(((m_position % m_outLength) << 15) / m_outLength);
+
+    out[count] = interpolate(m_window + base, mu);
+
+    // The input that the output lies just after, the first of a block may lie in the history
+    int32_t index = int32_t(base) - int32_t(SYMBOL_DECIMATOR_HISTORY);
+
+    if (rssiOut != NULL)
+      rssiOut[count] = rssi[index < 0 ? 0 : index];
+
+    if (controlOut != NULL) {
+      uint8_t mark = m_control;
+      m_control = MARK_NONE;
+
+      for (; int32_t(controlPtr) <= index; controlPtr++) {
+        if (control[controlPtr] != MARK_NONE)
+          mark = control[controlPtr];
+      }
+
+      controlOut[count] = mark;
+    }
+
+    count++;
+    m_position += m_inLength;
+  }
+
+  // Marks after the last output go with the first output of the next block
+  if (controlOut != NULL) {
+    for (; controlPtr < length; controlPtr++) {
+      if (control[controlPtr] != MARK_NONE)
+        m_control = control[controlPtr];
+    }
+  }
+
+  m_position -= uint32_t(length) * m_outLength;
+
+  ::memmove(m_window, m_window + length, SYMBOL_DECIMATOR_HISTORY * sizeof(q15_t));
+
+  return count;
+}
+
+q15_t CSymbolDecimator::interpolate(const q15_t* x, q31_t mu)
+{
+  q31_t xm1 = x[-1];
+  q31_t x0  = x[0];
+  q31_t x1  = x[1];
+  q31_t x2  = x[2];
+
+  // Farrow form with all terms times six
+  q31_t c1 = -2 * xm1 - 3 * x0 + 6 * x1 - x2;
+  q31_t c2 =  3 * xm1 - 6 * x0 + 3 * x1;
+  q31_t c3 = -xm1 + 3 * x0 - 3 * x1 + x2;
+
+  q63_t acc = c3;
+  acc = c2 + ((acc * mu) >> 15);
+  acc = c1 + ((acc * mu) >> 15);
+  acc = 6 * x0 + ((acc * mu) >> 15);
+
+  return q15_t(__SSAT(q31_t(acc / 6), 16));
+}
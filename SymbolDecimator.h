@@ -0,0 +1,58 @@
+/*
+ *   Fractional decimator for the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(SYMBOLDECIMATOR_H)
+#define  SYMBOLDECIMATOR_H
+
+#include "Globals.h"
+
+// Largest block handled in one pass, longer blocks are split internally
+const uint16_t SYMBOL_DECIMATOR_BLOCK_SIZE = 480U;
+
+// Samples kept from the previous block for the interpolator
+const uint16_t SYMBOL_DECIMATOR_HISTORY = 3U;
+
+class CSymbolDecimator {
+public:
+  CSymbolDecimator();
+
+  // Resamples from inLength to outLength samples per symbol, outLength no more than inLength.
+  // The ratio need not be whole, the fractional positions come from a cubic interpolator.
+  void setRatio(uint16_t inLength, uint16_t outLength);
+
+  void reset();
+
+  // Returns the number of samples written, at most length * outLength / inLength + 1. Each
+  // output takes the RSSI of the input it was interpolated from and any control mark seen since
+  // the previous output. The RSSI and control arrays may be NULL.
+  uint16_t process(const q15_t* in, const uint16_t* rssi, const uint8_t* control, uint16_t length, q15_t* out, uint16_t* rssiOut, uint8_t* controlOut);
+
+  // Cubic Lagrange interpolation mu of the way from x[0] to x[1], mu in q15, using x[-1] to x[2]
+  static q15_t interpolate(const q15_t* x, q31_t mu);
+
+private:
+  uint16_t m_inLength;
+  uint16_t m_outLength;
+  uint32_t m_position;                     // Next output in 1/m_outLength of an input sample
+  uint8_t  m_control;                      // Mark seen after the last output, for the next one
+  q15_t    m_window[SYMBOL_DECIMATOR_HISTORY + SYMBOL_DECIMATOR_BLOCK_SIZE];
+
+  uint16_t processBlock(const q15_t* in, const uint16_t* rssi, const uint8_t* control, uint16_t length, q15_t* out, uint16_t* rssiOut, uint8_t* controlOut);
+};
+
+#endif
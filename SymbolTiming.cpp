@@ -0,0 +1,153 @@
+/*
+ *   Symbol timing recovery for the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "SymbolTiming.h"
+#include "SymbolDecimator.h"
+
+// Proportional and integral gains of the loop filter as right shifts of the timing error. These
+// lock from any starting phase within about 500 symbols and hold lock with the sample clocks
+// 1000 ppm apart, see tests/SymbolTimingTest.cpp.
+const uint8_t SYMBOL_TIMING_KP_SHIFT = 3U;
+const uint8_t SYMBOL_TIMING_KI_SHIFT = 10U;
+
+// The loop may pull the symbol period by at most this, q16 samples
+const int32_t SYMBOL_TIMING_MAX_PULL = 1 << 13;
+
+// Starting value of the strobe magnitude average
+const q15_t SYMBOL_TIMING_LEVEL = 4096;
+
+CSymbolTiming::CSymbolTiming() :
+m_symbolLength(1U),
+m_position(0),
+m_integrator(0),
+m_last(0),
+m_centre(0),
+m_level(SYMBOL_TIMING_LEVEL),
+m_window()
+{
+}
+
+void CSymbolTiming::setSymbolLength(uint16_t symbolLength)
+{
+  m_symbolLength = symbolLength;
+
+  reset();
+}
+
+void CSymbolTiming::reset()
+{
+  // The earliest strobe that still has a sample before it in the history
+  m_position   = 1 << 16;
+  m_integrator = 0;
+  m_last       = 0;
+  m_centre     = 0;
+  m_level      = SYMBOL_TIMING_LEVEL;
+
+  ::memset(m_window, 0x00U, sizeof(m_window));
+}
+
+uint16_t CSymbolTiming::process(const q15_t* in, const uint16_t* rssi, uint16_t length, q15_t* out, uint16_t* rssiOut)
+{
+  uint16_t count = 0U;
+
+  while (length > 0U) {
+    uint16_t n = length > SYMBOL_TIMING_BLOCK_SIZE ? SYMBOL_TIMING_BLOCK_SIZE : length;
+
+    count += processBlock(in, rssi, n, out + count, rssiOut + count);
+
+    in     += n;
+    rssi   += n;
+    length -= n;
+  }
+
+  return count;
+}
+
+q31_t CSymbolTiming::decide(q31_t value) const
+{
+  // The outer symbols are three times the inner ones, so the average magnitude is twice an inner
+  // symbol and is also the threshold between them
+  q31_t symbol = (value < 0 ? -value : value) > m_level ? (3 * m_level) / 2 : m_level / 2;
+
+  return value < 0 ? -symbol : symbol;
+}
+
+uint16_t CSymbolTiming::processBlock(const q15_t* in, const uint16_t* rssi, uint16_t length, q15_t* out, uint16_t* rssiOut)
+{
+  ::memcpy(m_window + SYMBOL_TIMING_HISTORY, in, length * sizeof(q15_t));
+
+  const int32_t period = int32_t(m_symbolLength) << 16;
+
+  uint16_t count = 0U;
+
+  // The interpolator needs two samples after the strobe
+  for (int32_t base = m_position >> 16; base <= int32_t(length) + int32_t(SYMBOL_TIMING_HISTORY) - 3; base = m_position >> 16) {
+    q15_t strobe = CSymbolDecimator::interpolate(m_window + base, (m_position & 0xFFFF) >> 1);
+
+    // Mueller and Muller's detector. With Nyquist pulses the previous symbol leaks into the
+    // strobe as much as the strobe leaks into the previous symbol only when both are centred.
+    // Gardner's detector has too much self noise at the 0.2 roll off of these modes and let the
+    // loop slip symbols. The decisions are made about the average strobe, so a DC offset on the
+    // discriminator output does not bias them. Dividing by the square of the level keeps the
+    // loop gain independent of the deviation.
+    q31_t current = q31_t(strobe) - m_centre;
+    q31_t last    = q31_t(m_last) - m_centre;
+
+    q31_t level2 = q31_t(m_level) * m_level;
+    if (level2 < 1)
+      level2 = 1;
+
+    q63_t error = ((q63_t(decide(last)) * current - q63_t(decide(current)) * last) << 16) / level2;
+    if (error > (1 << 16))
+      error = 1 << 16;
+    else if (error < -(1 << 16))
+      error = -(1 << 16);
+
+    // The integrator keeps the unshifted sum, shifting each error first would bias it
+    m_integrator += q31_t(error);
+    if (m_integrator > (SYMBOL_TIMING_MAX_PULL << SYMBOL_TIMING_KI_SHIFT))
+      m_integrator = SYMBOL_TIMING_MAX_PULL << SYMBOL_TIMING_KI_SHIFT;
+    else if (m_integrator < -(SYMBOL_TIMING_MAX_PULL << SYMBOL_TIMING_KI_SHIFT))
+      m_integrator = -(SYMBOL_TIMING_MAX_PULL << SYMBOL_TIMING_KI_SHIFT);
+
+    m_position += period + (m_integrator >> SYMBOL_TIMING_KI_SHIFT) + (q31_t(error) >> SYMBOL_TIMING_KP_SHIFT);
+
+    // Averaged over more symbols than the level, its noise moves every decision threshold
+    m_centre += q15_t(current >> 8);
+
+    q31_t magnitude = current < 0 ? -current : current;
+    m_level += q15_t((magnitude - m_level) >> 6);
+
+    m_last = strobe;
+
+    out[count] = strobe;
+
+    int32_t index = base - int32_t(SYMBOL_TIMING_HISTORY);
+    rssiOut[count] = rssi[index < 0 ? 0 : index];
+
+    count++;
+  }
+
+  m_position -= int32_t(length) << 16;
+
+  ::memmove(m_window, m_window + length, SYMBOL_TIMING_HISTORY * sizeof(q15_t));
+
+  return count;
+}
@@ -0,0 +1,57 @@
+/*
+ *   Symbol timing recovery for the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(SYMBOLTIMING_H)
+#define  SYMBOLTIMING_H
+
+#include "Globals.h"
+
+// Largest block handled in one pass, longer blocks are split internally
+const uint16_t SYMBOL_TIMING_BLOCK_SIZE = 480U;
+
+// Samples kept from the previous block, enough for the interpolator around the first strobe
+const uint16_t SYMBOL_TIMING_HISTORY = 3U;
+
+class CSymbolTiming {
+public:
+  CSymbolTiming();
+
+  // Samples per symbol of the input, 2 to 5
+  void setSymbolLength(uint16_t symbolLength);
+
+  void reset();
+
+  // Writes one value per symbol, interpolated at the tracked symbol centre, with the RSSI of
+  // the input it was interpolated from. Returns the number of symbols written, at most
+  // length / symbolLength + 1.
+  uint16_t process(const q15_t* in, const uint16_t* rssi, uint16_t length, q15_t* out, uint16_t* rssiOut);
+
+private:
+  uint16_t m_symbolLength;
+  int32_t  m_position;                     // Next strobe in the window, q16 samples
+  int32_t  m_integrator;                   // Loop filter frequency term, q16 samples per symbol scaled up by the integral shift
+  q15_t    m_last;                         // Previous strobe
+  q15_t    m_centre;                       // Average strobe, the DC the decisions are made about
+  q15_t    m_level;                        // Average strobe magnitude about the centre, for the decisions and the error detector gain
+  q15_t    m_window[SYMBOL_TIMING_HISTORY + SYMBOL_TIMING_BLOCK_SIZE];
+
+  q31_t    decide(q31_t value) const;
+  uint16_t processBlock(const q15_t* in, const uint16_t* rssi, uint16_t length, q15_t* out, uint16_t* rssiOut);
+};
+
+#endif
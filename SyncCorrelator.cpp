@@ -0,0 +1,80 @@
+/*
+ *   Sync correlator shared by the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "SyncCorrelator.h"
+
+CSyncCorrelator::CSyncCorrelator() :
+m_weights(),
+m_length(0U),
+m_symbolLength(1U),
+m_phase(0U),
+m_ptr(),
+m_history()
+{
+}
+
+void CSyncCorrelator::setSync(const int8_t* values, uint8_t length, uint16_t symbolLength)
+{
+  // A positive symbol is a negative sample out of the discriminator
+  for (uint8_t i = 0U; i < length; i++)
+    m_weights[i] = -values[i];
+
+  m_length       = length;
+  m_symbolLength = symbolLength;
+
+  reset();
+}
+
+void CSyncCorrelator::reset()
+{
+  m_phase = 0U;
+
+  ::memset(m_ptr, 0x00U, sizeof(m_ptr));
+  ::memset(m_history, 0x00U, sizeof(m_history));
+}
+
+void CSyncCorrelator::write(q15_t val)
+{
+  m_phase++;
+  if (m_phase >= m_symbolLength)
+    m_phase = 0U;
+
+  // Each value goes in twice, length apart, so the last length values of a phase always lie
+  // together behind its pointer
+  q15_t* history = m_history[m_phase];
+  uint8_t ptr    = m_ptr[m_phase];
+
+  history[ptr]            = val;
+  history[ptr + m_length] = val;
+
+  ptr++;
+  if (ptr >= m_length)
+    ptr = 0U;
+
+  m_ptr[m_phase] = ptr;
+}
+
+q31_t CSyncCorrelator::correlate(q15_t& min, q15_t& max) const
+{
+  q31_t corr;
+  arm_dot_prod_min_max_q15(m_weights, m_history[m_phase] + m_ptr[m_phase], m_length, &corr, &min, &max);
+
+  return corr;
+}
@@ -0,0 +1,56 @@
+/*
+ *   Sync correlator shared by the 4FSK receivers
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(SYNCCORRELATOR_H)
+#define  SYNCCORRELATOR_H
+
+#include "Globals.h"
+
+// Longest sync handled, the DMR and P25 syncs
+const uint8_t SYNC_CORRELATOR_MAX_SYMBOLS = 24U;
+
+// Most samples per symbol between the values correlated
+const uint16_t SYNC_CORRELATOR_MAX_SYMBOL_LENGTH = 5U;
+
+class CSyncCorrelator {
+public:
+  CSyncCorrelator();
+
+  // The sync as +3, +1, -1 and -3 symbol values, and the spacing of the symbols in the input,
+  // one for a symbol stream.
+  void setSync(const int8_t* values, uint8_t length, uint16_t symbolLength);
+
+  void reset();
+
+  void write(q15_t val);
+
+  // Correlates the sync against the last length symbols ending at the newest value and finds
+  // their smallest and largest values in the same pass. The symbols are held in the order they
+  // arrived, one copy per sample phase, so the window never wraps.
+  q31_t correlate(q15_t& min, q15_t& max) const;
+
+private:
+  q15_t    m_weights[SYNC_CORRELATOR_MAX_SYMBOLS];
+  uint8_t  m_length;
+  uint16_t m_symbolLength;
+  uint16_t m_phase;                        // Phase of the newest value
+  uint8_t  m_ptr[SYNC_CORRELATOR_MAX_SYMBOL_LENGTH];
+  q15_t    m_history[SYNC_CORRELATOR_MAX_SYMBOL_LENGTH][2U * SYNC_CORRELATOR_MAX_SYMBOLS];
+};
+
+#endif
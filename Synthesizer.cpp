@@ -0,0 +1,101 @@
+/*
+ *   Polyphase synthesis filter bank for the SoapySX TX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Synthesizer.h"
+
+#include <cstring>
+
+CSynthesizer::CSynthesizer() :
+m_channels(0U),
+m_interpolation(1U),
+m_taps(0U),
+m_coeffs(),
+m_acc(),
+m_paths(),
+m_odd(false),
+m_fft()
+{
+}
+
+bool CSynthesizer::setChannels(uint16_t channels)
+{
+  if (channels < 2U || channels > CHANNELIZER_MAX_CHANNELS || !m_fft.setSize(channels))
+    return false;
+
+  m_channels      = channels;
+  m_interpolation = channels / 2U;
+  m_taps          = CChannelizer::designPrototype(channels, m_coeffs);
+
+  // Interpolating by N / 2 spreads the energy of each input sample, restore unity gain
+  for (uint16_t n = 0U; n < m_taps; n++)
+    m_coeffs[n] *= float(m_interpolation);
+
+  reset();
+
+  return true;
+}
+
+void CSynthesizer::reset()
+{
+  m_odd = false;
+
+  for (uint16_t i = 0U; i < m_taps; i++)
+    m_acc[i] = std::complex<float>(0.0F, 0.0F);
+}
+
+uint16_t CSynthesizer::process(const std::complex<float>* const* in, uint16_t length, std::complex<float>* out)
+{
+  if (m_channels == 0U)
+    return 0U;
+
+  const uint16_t mask = m_channels - 1U;
+  const uint16_t tail = m_taps - m_interpolation;
+
+  uint16_t n = 0U;
+
+  for (uint16_t i = 0U; i < length; i++) {
+    // Pre-rotate by pi * k per input, the mirror of the channelizer's correction
+    for (uint16_t k = 0U; k < m_channels; k++) {
+      if (in[k] == NULL) {
+        m_paths[k] = std::complex<float>(0.0F, 0.0F);
+      } else {
+        bool negate = m_odd && (k & 1U) != 0U;
+        m_paths[k] = negate ? -in[k][i] : in[k][i];
+      }
+    }
+    m_odd = !m_odd;
+
+    // The inverse DFT shifts every channel up to its offset at once
+    m_fft.inverse(m_paths);
+
+    // Each path output is filtered by every Nth tap and overlap-added into the output
+    for (uint16_t l = 0U; l < m_taps; l++)
+      m_acc[l] += m_coeffs[l] * m_paths[l & mask];
+
+    ::memcpy(out + n, m_acc, m_interpolation * sizeof(std::complex<float>));
+    n += m_interpolation;
+
+    ::memmove(m_acc, m_acc + m_interpolation, tail * sizeof(std::complex<float>));
+    for (uint16_t l = tail; l < m_taps; l++)
+      m_acc[l] = std::complex<float>(0.0F, 0.0F);
+  }
+
+  return n;
+}
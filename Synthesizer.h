@@ -0,0 +1,57 @@
+/*
+ *   Polyphase synthesis filter bank for the SoapySX TX path
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(SYNTHESIZER_H)
+#define  SYNTHESIZER_H
+
+#include "Globals.h"
+#include "Channelizer.h"
+#include "FFT.h"
+
+#include <complex>
+
+// The transmit mirror of CChannelizer. Takes N channels at twice the channel spacing,
+// interpolates each by N / 2 and sums them, shifted to k * fs / N, into one wideband stream.
+class CSynthesizer {
+public:
+  CSynthesizer();
+
+  // The channel count must be a power of two from 2 to CHANNELIZER_MAX_CHANNELS
+  bool setChannels(uint16_t channels);
+
+  void reset();
+
+  uint16_t getChannels() const { return m_channels; }
+  uint16_t getInterpolation() const { return m_interpolation; }
+
+  // in holds one buffer of length samples per channel, a NULL buffer is a silent channel.
+  // out must have room for length * N / 2 samples. Returns the number of samples written.
+  uint16_t process(const std::complex<float>* const* in, uint16_t length, std::complex<float>* out);
+
+private:
+  uint16_t            m_channels;
+  uint16_t            m_interpolation;
+  uint16_t            m_taps;
+  float               m_coeffs[CHANNELIZER_MAX_CHANNELS * CHANNELIZER_TAPS_PER_PATH];
+  std::complex<float> m_acc[CHANNELIZER_MAX_CHANNELS * CHANNELIZER_TAPS_PER_PATH];
+  std::complex<float> m_paths[CHANNELIZER_MAX_CHANNELS];
+  bool                m_odd;
+  CFFT                m_fft;
+};
+
+#endif
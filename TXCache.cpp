@@ -0,0 +1,109 @@
+/*
+ *   Cache of modulated, level scaled samples for the bursts the transmitters repeat
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "TXCache.h"
+
+CTXCache::CTXCache(MMDVM_STATE mode, uint16_t length) :
+m_mode(mode),
+m_samples(NULL),
+m_size(length),
+m_length(0U),
+m_serial(0U),
+m_burst(),
+m_burstLength(0U)
+{
+  m_samples = new uint16_t[length];
+}
+
+bool CTXCache::isValid() const
+{
+  return m_length > 0U && m_serial == io.getLevelSerial();
+}
+
+void CTXCache::invalidate()
+{
+  m_length = 0U;
+}
+
+uint16_t CTXCache::getLength() const
+{
+  return isValid() ? m_length : 0U;
+}
+
+void CTXCache::store(const q15_t* samples, uint16_t length)
+{
+  if (length > m_size)
+    length = m_size;
+
+  io.scale(m_mode, samples, m_samples, length);
+
+  m_length = length;
+  m_serial = io.getLevelSerial();
+}
+
+void CTXCache::write(uint16_t offset, uint16_t length, const uint8_t* control) const
+{
+  io.writeScaled(m_samples + offset, length, control);
+}
+
+template <class MOD>
+void CTXCache::writeBurst(MOD& modulator, const uint8_t* burst, uint16_t burstLength, uint16_t offset, uint16_t length)
+{
+  static_assert(MOD::BYTE_SAMPLES * TX_CACHE_BURST_BYTES <= TX_CACHE_BURST_SAMPLES, "a burst of TX_CACHE_BURST_BYTES overflows the samples");
+
+  q15_t buffer[MOD::BYTE_SAMPLES];
+
+  // The settling bytes are modulated, and all of a burst that doesn't fit the cache
+  uint32_t direct = MOD::SETTLE_BYTES;
+  if (burstLength > TX_CACHE_BURST_BYTES || uint32_t(burstLength) * MOD::BYTE_SAMPLES > m_size || uint32_t(offset) + length > burstLength)
+    direct = uint32_t(offset) + length;
+
+  while (offset < direct && length > 0U) {
+    modulator.modulate(burst + offset, 1U, buffer);
+    io.write(m_mode, buffer, MOD::BYTE_SAMPLES);
+
+    offset++;
+    length--;
+  }
+
+  if (length == 0U)
+    return;
+
+  if (!isValid() || burstLength != m_burstLength || ::memcmp(burst, m_burst, burstLength) != 0) {
+    q15_t samples[TX_CACHE_BURST_SAMPLES];
+
+    // Any history gives the same samples once the burst has settled
+    MOD fill = modulator;
+    fill.modulate(burst, burstLength, samples);
+
+    store(samples, burstLength * MOD::BYTE_SAMPLES);
+
+    ::memcpy(m_burst, burst, burstLength);
+    m_burstLength = burstLength;
+  }
+
+  write(offset * MOD::BYTE_SAMPLES, length * MOD::BYTE_SAMPLES);
+
+  modulator.advance(burst + offset, length);
+}
+
+// The modulators with bursts kept here
+template void CTXCache::writeBurst(C4FSKTX<DMR_RADIO_SYMBOL_LENGTH>&, const uint8_t*, uint16_t, uint16_t, uint16_t);
+template void CTXCache::writeBurst(CGMSKTX<DSTAR_RADIO_BIT_LENGTH>&, const uint8_t*, uint16_t, uint16_t, uint16_t);
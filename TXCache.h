@@ -0,0 +1,69 @@
+/*
+ *   Cache of modulated, level scaled samples for the bursts the transmitters repeat
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(TXCACHE_H)
+#define  TXCACHE_H
+
+#include "Config.h"
+#include "Globals.h"
+
+// Longest burst writeBurst() takes, in bytes, and the samples it can modulate to at the 40 per byte
+// of D-Star, the most of any modulator. A DMR frame of 33 bytes is the longest burst sent.
+const uint16_t TX_CACHE_BURST_BYTES   = 40U;
+const uint16_t TX_CACHE_BURST_SAMPLES = TX_CACHE_BURST_BYTES * 40U;
+
+/*
+ * Holds samples already scaled to the TX level of a mode, so a burst that is sent again and again
+ * goes to the IO with one copy. The samples go stale when the IO's levels change.
+ */
+class CTXCache {
+public:
+  CTXCache(MMDVM_STATE mode, uint16_t length);
+
+  // Filled at the IO's current levels
+  bool isValid() const;
+
+  void invalidate();
+
+  // Samples held, zero when not valid
+  uint16_t getLength() const;
+
+  // Scales and keeps length samples, at most the length given to the constructor
+  void store(const q15_t* samples, uint16_t length);
+
+  // Sends length of the samples starting at offset
+  void write(uint16_t offset, uint16_t length, const uint8_t* control = NULL) const;
+
+  // Sends length bytes from offset of a burst whose samples past the modulator's settling bytes
+  // don't depend on what went before it. Those come from the cache, which is filled again when it
+  // isn't valid or holds a different burst, and the rest are modulated. A burst the cache can't
+  // hold is modulated as it is sent.
+  template <class MOD>
+  void writeBurst(MOD& modulator, const uint8_t* burst, uint16_t burstLength, uint16_t offset, uint16_t length);
+
+private:
+  MMDVM_STATE m_mode;
+  uint16_t*   m_samples;
+  uint16_t    m_size;
+  uint16_t    m_length;
+  uint32_t    m_serial;
+  uint8_t     m_burst[TX_CACHE_BURST_BYTES];
+  uint16_t    m_burstLength;
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ *   Coefficient tables and levels of the TX modulators
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(TXFILTERS_H)
+#define  TXFILTERS_H
+
+#include "Globals.h"
+#include "FilterDesign.h"
+#include "GMSKTX.h"
+#include "4FSKTX.h"
+#include "DStarDefines.h"
+#include "DMRDefines.h"
+#include "YSFDefines.h"
+#include "P25Defines.h"
+#include "NXDNDefines.h"
+
+// gaussfir(0.35, 1, DSTAR_RADIO_BIT_LENGTH) peak normalised, padded at the front to whole phases
+const uint16_t GAUSSIAN_0_35_FILTER_PHASE_LEN = 3U; // phaseLength = numTaps/L
+static constexpr auto GAUSSIAN_0_35_FILTER = txTaps<GAUSSIAN_0_35_FILTER_PHASE_LEN * DSTAR_RADIO_BIT_LENGTH>(normalisePeak(designGaussian<1U, DSTAR_RADIO_BIT_LENGTH>(0.35)), 32767.0);
+
+const q15_t DSTAR_LEVEL0 = -841;
+const q15_t DSTAR_LEVEL1 =  841;
+
+// A set bit is sent at LEVEL0
+static constexpr auto DSTAR_MOD_TABLE = gmskTable<DSTAR_RADIO_BIT_LENGTH>(GAUSSIAN_0_35_FILTER, DSTAR_LEVEL1, DSTAR_LEVEL0);
+
+// rcosdesign(0.2, 8, sps, 'sqrt') peak normalised, padded at the front to whole phases
+const uint16_t RRC_0_2_TX_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
+static constexpr auto DMR_RRC_0_2_FILTER  = txTaps<RRC_0_2_TX_FILTER_PHASE_LEN * DMR_RADIO_SYMBOL_LENGTH>(normalisePeak(designRRC<8U, DMR_RADIO_SYMBOL_LENGTH>(0.2)), 32767.0);
+static constexpr auto YSF_RRC_0_2_FILTER  = txTaps<RRC_0_2_TX_FILTER_PHASE_LEN * YSF_RADIO_SYMBOL_LENGTH>(normalisePeak(designRRC<8U, YSF_RADIO_SYMBOL_LENGTH>(0.2)), 32767.0);
+static constexpr auto NXDN_RRC_0_2_FILTER = txTaps<RRC_0_2_TX_FILTER_PHASE_LEN * NXDN_RADIO_SYMBOL_LENGTH>(normalisePeak(designRRC<8U, NXDN_RADIO_SYMBOL_LENGTH>(0.2)), 32767.0);
+
+// rcosdesign(0.2, 8, P25_RADIO_SYMBOL_LENGTH, 'normal') peak normalised, less its leading zero
+const uint16_t P25_RC_0_2_FILTER_PHASE_LEN = 8U; // phaseLength = numTaps/L
+static constexpr auto P25_RC_0_2_FILTER = txTaps<P25_RC_0_2_FILTER_PHASE_LEN * P25_RADIO_SYMBOL_LENGTH>(normalisePeak(designRC<8U, P25_RADIO_SYMBOL_LENGTH>(0.2)), 32767.0);
+
+// Run by the P25 and NXDN transmitters over the modulator output
+static const q15_t P25_LOWPASS_FILTER[] = {124, -188, -682, 1262, 556, -621, -1912, -911, 2058, 3855, 1234, -4592, -7692, -2799,
+                                           8556, 18133, 18133, 8556, -2799, -7692, -4592, 1234, 3855, 2058, -911, -1912, -621,
+                                           556, 1262, -682, -188, 124};
+const uint16_t P25_LOWPASS_FILTER_LEN = 32U;
+
+static const q15_t NXDN_SINC_FILTER[] = {572, -1003, -253, 254, 740, 1290, 1902, 2527, 3090, 3517, 3747, 3747, 3517, 3090, 2527, 1902,
+                                         1290, 740, 254, -253, -1003, 572};
+const uint16_t NXDN_SINC_FILTER_LEN = 22U;
+
+const q15_t DMR_LEVELA =  1362;
+const q15_t DMR_LEVELB =  454;
+const q15_t DMR_LEVELC = -454;
+const q15_t DMR_LEVELD = -1362;
+
+const q15_t YSF_LEVELA_HI =  1893;
+const q15_t YSF_LEVELB_HI =  631;
+const q15_t YSF_LEVELC_HI = -631;
+const q15_t YSF_LEVELD_HI = -1893;
+
+const q15_t YSF_LEVELA_LO =  948;
+const q15_t YSF_LEVELB_LO =  316;
+const q15_t YSF_LEVELC_LO = -316;
+const q15_t YSF_LEVELD_LO = -948;
+
+const q15_t P25_LEVELA =  1260;
+const q15_t P25_LEVELB =   420;
+const q15_t P25_LEVELC =  -420;
+const q15_t P25_LEVELD = -1260;
+
+const q15_t NXDN_LEVELA =  735;
+const q15_t NXDN_LEVELB =  245;
+const q15_t NXDN_LEVELC = -245;
+const q15_t NXDN_LEVELD = -735;
+
+static constexpr auto DMR_MOD_TABLE    = modTable<DMR_RADIO_SYMBOL_LENGTH>(DMR_RRC_0_2_FILTER, DMR_LEVELA, DMR_LEVELB, DMR_LEVELC, DMR_LEVELD);
+static constexpr auto YSF_MOD_TABLE_HI = modTable<YSF_RADIO_SYMBOL_LENGTH>(YSF_RRC_0_2_FILTER, YSF_LEVELA_HI, YSF_LEVELB_HI, YSF_LEVELC_HI, YSF_LEVELD_HI);
+static constexpr auto YSF_MOD_TABLE_LO = modTable<YSF_RADIO_SYMBOL_LENGTH>(YSF_RRC_0_2_FILTER, YSF_LEVELA_LO, YSF_LEVELB_LO, YSF_LEVELC_LO, YSF_LEVELD_LO);
+static constexpr auto P25_MOD_TABLE    = modTable<P25_RADIO_SYMBOL_LENGTH>(P25_RC_0_2_FILTER, P25_LEVELA, P25_LEVELB, P25_LEVELC, P25_LEVELD);
+static constexpr auto NXDN_MOD_TABLE   = modTable<NXDN_RADIO_SYMBOL_LENGTH>(NXDN_RRC_0_2_FILTER, NXDN_LEVELA, NXDN_LEVELB, NXDN_LEVELC, NXDN_LEVELD);
+
+#endif
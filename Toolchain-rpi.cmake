@@ -1,14 +1,16 @@
 # Define our host system
 SET(CMAKE_SYSTEM_NAME Linux)
 SET(CMAKE_SYSTEM_VERSION 1)
-# Define the cross compiler locations
-SET(CMAKE_C_COMPILER   /home/rax/mmdvm/tools/arm-bcm2708/arm-rpi-4.9.3-linux-gnueabihf/bin/arm-linux-gnueabihf-gcc)
-SET(CMAKE_CXX_COMPILER /home/rax/mmdvm/tools/arm-bcm2708/arm-rpi-4.9.3-linux-gnueabihf/bin/arm-linux-gnueabihf-gcc)
-# Define the sysroot path for the RaspberryPi distribution in our tools folder 
-SET(CMAKE_FIND_ROOT_PATH /home/rax/mmdvm/tools/arm-bcm2708/arm-rpi-4.9.3-linux-gnueabihf/arm-linux-gnueabihf/sysroot/)
+SET(CMAKE_SYSTEM_PROCESSOR arm)
+# Define the cross compiler locations, the Debian/Ubuntu gcc-arm-linux-gnueabihf and
+# g++-arm-linux-gnueabihf packages. The old rpitools GCC 4.9 has no C++17.
+SET(CMAKE_C_COMPILER   arm-linux-gnueabihf-gcc)
+SET(CMAKE_CXX_COMPILER arm-linux-gnueabihf-g++)
+# Define the sysroot path, the target libraries and SoapySDR have to be installed under it
+SET(CMAKE_FIND_ROOT_PATH /usr/arm-linux-gnueabihf)
 # Use our definitions for compiler tools
 SET(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
 # Search for libraries and headers in the target directories only
 SET(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
 SET(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
-add_definitions(-Wall -std=c++11 -D_GNU_SOURCE)
+add_definitions(-Wall -std=c++17 -D_GNU_SOURCE)
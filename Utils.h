@@ -33,11 +33,28 @@
 #include <Arduino.h>
 #endif
 
-uint8_t countBits8(uint8_t bits);
+// The compiler builtins become POPCNT on x86 when ENABLE_POPCNT is set in CMakeLists.txt and CNT
+// on AArch64, elsewhere they fall back to the compiler's own bit counting
+inline uint8_t countBits8(uint8_t bits)
+{
+  return uint8_t(__builtin_popcount(bits));
+}
 
-uint8_t countBits32(uint32_t bits);
+inline uint8_t countBits32(uint32_t bits)
+{
+  return uint8_t(__builtin_popcount(bits));
+}
 
-uint8_t countBits64(uint64_t bits);
+inline uint8_t countBits64(uint64_t bits)
+{
+  return uint8_t(__builtin_popcountll(bits));
+}
+
+// Number of bits in which a received sync word differs from the expected one within the mask
+inline uint8_t countSyncErrs(uint64_t bits, uint64_t sync, uint64_t mask)
+{
+  return countBits64((bits ^ sync) & mask);
+}
 
 #endif
 
@@ -22,42 +22,20 @@
 #include "YSFTX.h"
 
 #include "YSFDefines.h"
-
-// Generated using rcosdesign(0.2, 8, 5, 'sqrt') in MATLAB
-static q15_t RRC_0_2_FILTER[] = {0, 0, 0, 0, 850, 219, -720, -1548, -1795, -1172, 237, 1927, 3120, 3073, 1447, -1431, -4544, -6442,
-                                 -5735, -1633, 5651, 14822, 23810, 30367, 32767, 30367, 23810, 14822, 5651, -1633, -5735, -6442,
-                                 -4544, -1431, 1447, 3073, 3120, 1927, 237, -1172, -1795, -1548, -720, 219, 850}; // numTaps = 45, L = 5
-const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
-
-const q15_t YSF_LEVELA_HI =  1893;
-const q15_t YSF_LEVELB_HI =  631;
-const q15_t YSF_LEVELC_HI = -631;
-const q15_t YSF_LEVELD_HI = -1893;
-
-const q15_t YSF_LEVELA_LO =  948;
-const q15_t YSF_LEVELB_LO =  316;
-const q15_t YSF_LEVELC_LO = -316;
-const q15_t YSF_LEVELD_LO = -948;
+#include "TXFilters.h"
 
 const uint8_t YSF_START_SYNC = 0x77U;
 const uint8_t YSF_END_SYNC   = 0xFFU;
 
 CYSFTX::CYSFTX() :
 m_buffer(1500U),
-m_modFilter(),
-m_modState(),
+m_modulator(YSF_MOD_TABLE_HI.data()),
+m_syncCache(STATE_YSF, YSF_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES),
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
-m_txDelay(240U),      // 200ms
-m_loDev(false)
+m_txDelay(240U)       // 200ms
 {
-  ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-  m_modFilter.L           = YSF_RADIO_SYMBOL_LENGTH;
-  m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = RRC_0_2_FILTER;
-  m_modFilter.pState      = m_modState;
 }
 
 void CYSFTX::process()
@@ -80,19 +58,16 @@ void CYSFTX::process()
   }
 
   if (m_poLen > 0U) {
-    uint16_t space = io.getSpace();
-    
-    while (space > (4U * YSF_RADIO_SYMBOL_LENGTH)) {
-      uint8_t c = m_poBuffer[m_poPtr++];
-      writeByte(c);
-
-      space -= 4U * YSF_RADIO_SYMBOL_LENGTH;
-      
-      if (m_poPtr >= m_poLen) {
-        m_poPtr = 0U;
-        m_poLen = 0U;
-        return;
-      }
+    uint16_t count = C4FSKTX<YSF_RADIO_SYMBOL_LENGTH>::getBytes(io.getSpace());
+    if (count > (m_poLen - m_poPtr))
+      count = m_poLen - m_poPtr;
+
+    writeBytes(m_poBuffer + m_poPtr, count);
+    m_poPtr += count;
+
+    if (m_poPtr >= m_poLen) {
+      m_poPtr = 0U;
+      m_poLen = 0U;
     }
   }
 }
@@ -112,33 +87,31 @@ uint8_t CYSFTX::writeData(const uint8_t* data, uint8_t length)
   return 0U;
 }
 
-void CYSFTX::writeByte(uint8_t c)
+void CYSFTX::writeBytes(const uint8_t* data, uint16_t length)
 {
-  q15_t inBuffer[4U];
-  q15_t outBuffer[YSF_RADIO_SYMBOL_LENGTH * 4U];
-
-  const uint8_t MASK = 0xC0U;
-
-  for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-    switch (c & MASK) {
-      case 0xC0U:
-        inBuffer[i] = m_loDev ? YSF_LEVELA_LO : YSF_LEVELA_HI;
-        break;
-      case 0x80U:
-        inBuffer[i] = m_loDev ? YSF_LEVELB_LO : YSF_LEVELB_HI;
-        break;
-      case 0x00U:
-        inBuffer[i] = m_loDev ? YSF_LEVELC_LO : YSF_LEVELC_HI;
-        break;
-      default:
-        inBuffer[i] = m_loDev ? YSF_LEVELD_LO : YSF_LEVELD_HI;
-        break;
-    }
-  }
+  q15_t outBuffer[YSF_RADIO_SYMBOL_LENGTH * 4U * TX_4FSK_BLOCK_BYTES];
+
+  while (length > 0U) {
+    uint16_t n = length > TX_4FSK_BLOCK_BYTES ? TX_4FSK_BLOCK_BYTES : length;
+
+    // Once the modulator has settled on the start sync its bytes are all the same
+    uint16_t run = m_modulator.getRun(YSF_START_SYNC, data, n);
+    uint16_t cached = m_syncCache.getLength() / (YSF_RADIO_SYMBOL_LENGTH * 4U);
+    if (run > 0U && cached > 0U) {
+      n = run < cached ? run : cached;
+      m_syncCache.write(0U, YSF_RADIO_SYMBOL_LENGTH * 4U * n);
+    } else {
+      m_modulator.modulate(data, n, outBuffer);
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+      if (run == n)
+        m_syncCache.store(outBuffer, YSF_RADIO_SYMBOL_LENGTH * 4U * n);
 
-  io.write(STATE_YSF, outBuffer, YSF_RADIO_SYMBOL_LENGTH * 4U);
+      io.write(STATE_YSF, outBuffer, YSF_RADIO_SYMBOL_LENGTH * 4U * n);
+    }
+
+    data   += n;
+    length -= n;
+  }
 }
 
 void CYSFTX::setTXDelay(uint8_t delay)
@@ -156,6 +129,8 @@ uint8_t CYSFTX::getSpace() const
 
 void CYSFTX::setLoDev(bool on)
 {
-  m_loDev = on;
+  m_modulator.setTable(on ? YSF_MOD_TABLE_LO.data() : YSF_MOD_TABLE_HI.data());
+
+  m_syncCache.invalidate();
 }
 
@@ -21,6 +21,9 @@
 
 #include "Config.h"
 
+#include "YSFDefines.h"
+#include "4FSKTX.h"
+#include "TXCache.h"
 #include "SerialRB.h"
 
 class CYSFTX {
@@ -39,15 +42,14 @@ public:
 
 private:
   CSerialRB                        m_buffer;
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
+  C4FSKTX<YSF_RADIO_SYMBOL_LENGTH> m_modulator;
+  CTXCache                         m_syncCache;
   uint8_t                          m_poBuffer[1200U];
   uint16_t                         m_poLen;
   uint16_t                         m_poPtr;
   uint16_t                         m_txDelay;
-  bool                             m_loDev;
 
-  void writeByte(uint8_t c);
+  void writeBytes(const uint8_t* data, uint16_t length);
 };
 
 #endif
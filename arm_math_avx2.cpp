@@ -0,0 +1,238 @@
+/*
+ *   AVX2 backend of the arm_math_rpi kernels
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if defined(RPI) && defined(ARM_MATH_AVX2)
+
+#include "arm_math_simd.h"
+
+#include <immintrin.h>
+
+#include <cstring>
+
+void arm_fir_interpolate_q15_avx2(
+  const arm_fir_interpolate_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  const q15_t* pCoeffs  = S->pCoeffs;
+  uint32_t     L        = S->L;
+  uint32_t     phaseLen = S->phaseLength;
+
+  ::memcpy(S->pState + phaseLen - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  // Four phases per pass as in the SSE4 version, with one 256 bit accumulator of 64 bit sums
+  for (uint32_t n = 0U; n < blockSize; n++) {
+    const q15_t* px = S->pState + n;
+
+    uint32_t j = 0U;
+    for (; j + 4U <= L; j += 4U) {
+      __m256i acc = _mm256_setzero_si256();
+
+      for (uint32_t t = 0U; t < phaseLen; t++) {
+        __m128i c = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(pCoeffs + j + t * L)));
+        __m128i p = _mm_mullo_epi32(c, _mm_set1_epi32(px[t]));
+
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(p));
+      }
+
+      q63_t sum[4U];
+      _mm256_storeu_si256((__m256i*)sum, acc);
+
+      // Phases are written last first
+      for (uint32_t m = 0U; m < 4U; m++)
+        pDst[L - 1U - j - m] = q15_t(__SSAT((sum[m] >> 15), 16));
+    }
+
+    for (; j < L; j++) {
+      q63_t sum = 0;
+      for (uint32_t t = 0U; t < phaseLen; t++)
+        sum += q31_t(px[t]) * pCoeffs[j + t * L];
+
+      pDst[L - 1U - j] = q15_t(__SSAT((sum >> 15), 16));
+    }
+
+    pDst += L;
+  }
+
+  ::memmove(S->pState, S->pState + blockSize, (phaseLen - 1U) * sizeof(q15_t));
+}
+
+void arm_fir_window_q15_avx2(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  // Sixteen outputs at a time, the same pairing as the SSE4 version. The unpacks work within
+  // each 128 bit lane and so does the final pack, which puts the outputs back in order.
+  uint32_t n = 0U;
+  for (; n + 16U <= blockSize; n += 16U) {
+    const q15_t* px = pSrc + n;
+
+    __m256i accLo = _mm256_setzero_si256();
+    __m256i accHi = _mm256_setzero_si256();
+
+    for (uint32_t k = 0U; k < numTaps; k += 2U) {
+      int32_t pair;
+      ::memcpy(&pair, pCoeffs + k, sizeof(int32_t));
+      __m256i c = _mm256_set1_epi32(pair);
+
+      __m256i a = _mm256_loadu_si256((const __m256i*)(px + k));
+      __m256i b = _mm256_loadu_si256((const __m256i*)(px + k + 1U));
+
+      accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), c));
+      accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), c));
+    }
+
+    accLo = _mm256_srai_epi32(accLo, 15);
+    accHi = _mm256_srai_epi32(accHi, 15);
+    _mm256_storeu_si256((__m256i*)(pDst + n), _mm256_packs_epi32(accLo, accHi));
+  }
+
+  for (; n + 8U <= blockSize; n += 8U) {
+    const q15_t* px = pSrc + n;
+
+    __m128i accLo = _mm_setzero_si128();
+    __m128i accHi = _mm_setzero_si128();
+
+    for (uint32_t k = 0U; k < numTaps; k += 2U) {
+      int32_t pair;
+      ::memcpy(&pair, pCoeffs + k, sizeof(int32_t));
+      __m128i c = _mm_set1_epi32(pair);
+
+      __m128i a = _mm_loadu_si128((const __m128i*)(px + k));
+      __m128i b = _mm_loadu_si128((const __m128i*)(px + k + 1U));
+
+      accLo = _mm_add_epi32(accLo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+      accHi = _mm_add_epi32(accHi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+    }
+
+    accLo = _mm_srai_epi32(accLo, 15);
+    accHi = _mm_srai_epi32(accHi, 15);
+    _mm_storeu_si128((__m128i*)(pDst + n), _mm_packs_epi32(accLo, accHi));
+  }
+
+  for (; n < blockSize; n++) {
+    const q15_t* px = pSrc + n;
+
+    uint32_t acc = 0U;
+    for (uint32_t k = 0U; k < numTaps; k++)
+      acc += uint32_t(q31_t(px[k]) * pCoeffs[k]);
+
+    q31_t res = q31_t(acc) >> 15;
+    pDst[n] = q15_t(__SSAT(res, 16));
+  }
+}
+
+void arm_fir_fast_q15_avx2(
+  const arm_fir_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t numTaps = S->numTaps;
+
+  ::memcpy(S->pState + numTaps - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  arm_fir_window_q15_avx2(S->pCoeffs, S->numTaps, S->pState, pDst, blockSize);
+
+  ::memmove(S->pState, S->pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+void arm_q15_to_q31_avx2(
+  q15_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + n)));
+    _mm256_storeu_si256((__m256i*)(pDst + n), _mm256_slli_epi32(x, 16));
+  }
+
+  for (; n < blockSize; n++)
+    pDst[n] = q31_t(uint32_t(pSrc[n]) << 16);
+}
+
+
+void arm_dot_prod_min_max_q15_avx2(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax)
+{
+  __m256i acc = _mm256_setzero_si256();
+  __m256i min = _mm256_set1_epi16(32767);
+  __m256i max = _mm256_set1_epi16(-32768);
+
+  // Sixteen at a time, VPMADDWD wraps in 32 bits like the reference
+  uint32_t n = 0U;
+  for (; n + 16U <= blockSize; n += 16U) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(pSrcA + n));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(pSrcB + n));
+
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+    min = _mm256_min_epi16(min, b);
+    max = _mm256_max_epi16(max, b);
+  }
+
+  __m128i acc4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  __m128i min8 = _mm_min_epi16(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+  __m128i max8 = _mm_max_epi16(_mm256_castsi256_si128(max), _mm256_extracti128_si256(max, 1));
+
+  // The eight left over from the sixteen
+  if (n + 8U <= blockSize) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(pSrcA + n));
+    __m128i b = _mm_loadu_si128((const __m128i*)(pSrcB + n));
+
+    acc4 = _mm_add_epi32(acc4, _mm_madd_epi16(a, b));
+    min8 = _mm_min_epi16(min8, b);
+    max8 = _mm_max_epi16(max8, b);
+
+    n += 8U;
+  }
+
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0x4E));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0xB1));
+  uint32_t sum = uint32_t(_mm_cvtsi128_si32(acc4));
+
+  // As in the SSE4.1 version, PHMINPOSUW after mapping the signed order onto the unsigned one
+  q15_t lo = q15_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(min8, _mm_set1_epi16(-32768)))) ^ 0x8000);
+  q15_t hi = q15_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(max8, _mm_set1_epi16(32767)))) ^ 0x7FFF);
+
+  for (; n < blockSize; n++) {
+    q15_t val = pSrcB[n];
+
+    sum += uint32_t(q31_t(pSrcA[n]) * val);
+
+    if (val < lo)
+      lo = val;
+    if (val > hi)
+      hi = val;
+  }
+
+  *result = q31_t(sum);
+  *pMin   = lo;
+  *pMax   = hi;
+}
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ *   NEON backend of the arm_math_rpi kernels
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if defined(RPI) && defined(ARM_MATH_NEON)
+
+#include "arm_math_simd.h"
+
+#include <arm_neon.h>
+
+#include <cstring>
+
+void arm_fir_interpolate_q15_neon(
+  const arm_fir_interpolate_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  const q15_t* pCoeffs  = S->pCoeffs;
+  uint32_t     L        = S->L;
+  uint32_t     phaseLen = S->phaseLength;
+
+  ::memcpy(S->pState + phaseLen - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  // The coefficients of one tap for every phase are adjacent, so four phases are summed
+  // together, in 64 bits like the reference
+  for (uint32_t n = 0U; n < blockSize; n++) {
+    const q15_t* px = S->pState + n;
+
+    uint32_t j = 0U;
+    for (; j + 4U <= L; j += 4U) {
+      int64x2_t acc0 = vdupq_n_s64(0);
+      int64x2_t acc1 = vdupq_n_s64(0);
+
+      for (uint32_t t = 0U; t < phaseLen; t++) {
+        int32x4_t p = vmull_n_s16(vld1_s16(pCoeffs + j + t * L), px[t]);
+
+        acc0 = vaddw_s32(acc0, vget_low_s32(p));
+        acc1 = vaddw_s32(acc1, vget_high_s32(p));
+      }
+
+      q63_t sum[4U];
+      vst1q_s64(sum + 0U, acc0);
+      vst1q_s64(sum + 2U, acc1);
+
+      // Phases are written last first
+      for (uint32_t m = 0U; m < 4U; m++)
+        pDst[L - 1U - j - m] = q15_t(__SSAT((sum[m] >> 15), 16));
+    }
+
+    for (; j < L; j++) {
+      q63_t sum = 0;
+      for (uint32_t t = 0U; t < phaseLen; t++)
+        sum += q31_t(px[t]) * pCoeffs[j + t * L];
+
+      pDst[L - 1U - j] = q15_t(__SSAT((sum >> 15), 16));
+    }
+
+    pDst += L;
+  }
+
+  ::memmove(S->pState, S->pState + blockSize, (phaseLen - 1U) * sizeof(q15_t));
+}
+
+void arm_fir_window_q15_neon(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  // Eight outputs at a time, each tap is multiplied into all eight with a widening
+  // multiply-accumulate. The sums wrap in 32 bits exactly as the reference does and the
+  // saturating narrow matches __SSAT.
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    const q15_t* px = pSrc + n;
+
+    int32x4_t accLo = vdupq_n_s32(0);
+    int32x4_t accHi = vdupq_n_s32(0);
+
+    for (uint32_t k = 0U; k < numTaps; k++) {
+      int16x8_t x = vld1q_s16(px + k);
+
+      accLo = vmlal_n_s16(accLo, vget_low_s16(x),  pCoeffs[k]);
+      accHi = vmlal_n_s16(accHi, vget_high_s16(x), pCoeffs[k]);
+    }
+
+    vst1q_s16(pDst + n, vcombine_s16(vqshrn_n_s32(accLo, 15), vqshrn_n_s32(accHi, 15)));
+  }
+
+  for (; n < blockSize; n++) {
+    const q15_t* px = pSrc + n;
+
+    uint32_t acc = 0U;
+    for (uint32_t k = 0U; k < numTaps; k++)
+      acc += uint32_t(q31_t(px[k]) * pCoeffs[k]);
+
+    q31_t res = q31_t(acc) >> 15;
+    pDst[n] = q15_t(__SSAT(res, 16));
+  }
+}
+
+void arm_fir_fast_q15_neon(
+  const arm_fir_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t numTaps = S->numTaps;
+
+  ::memcpy(S->pState + numTaps - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  arm_fir_window_q15_neon(S->pCoeffs, S->numTaps, S->pState, pDst, blockSize);
+
+  ::memmove(S->pState, S->pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+void arm_q15_to_q31_neon(
+  q15_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    int16x8_t x = vld1q_s16(pSrc + n);
+
+    vst1q_s32(pDst + n,      vshll_n_s16(vget_low_s16(x),  16));
+    vst1q_s32(pDst + n + 4U, vshll_n_s16(vget_high_s16(x), 16));
+  }
+
+  for (; n < blockSize; n++)
+    pDst[n] = q31_t(uint32_t(pSrc[n]) << 16);
+}
+
+
+void arm_dot_prod_min_max_q15_neon(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax)
+{
+  int32x4_t acc = vdupq_n_s32(0);
+  int16x8_t min = vdupq_n_s16(32767);
+  int16x8_t max = vdupq_n_s16(-32768);
+
+  // Eight at a time, the widening multiply accumulates wrap in 32 bits like the reference
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    int16x8_t a = vld1q_s16(pSrcA + n);
+    int16x8_t b = vld1q_s16(pSrcB + n);
+
+    acc = vmlal_s16(acc, vget_low_s16(a),  vget_low_s16(b));
+    acc = vmlal_s16(acc, vget_high_s16(a), vget_high_s16(b));
+    min = vminq_s16(min, b);
+    max = vmaxq_s16(max, b);
+  }
+
+  // Pairwise folds work on both ARMv7 and AArch64
+  int32x2_t acc2 = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+  acc2 = vpadd_s32(acc2, acc2);
+
+  int16x4_t min4 = vmin_s16(vget_low_s16(min), vget_high_s16(min));
+  min4 = vpmin_s16(min4, min4);
+  min4 = vpmin_s16(min4, min4);
+
+  int16x4_t max4 = vmax_s16(vget_low_s16(max), vget_high_s16(max));
+  max4 = vpmax_s16(max4, max4);
+  max4 = vpmax_s16(max4, max4);
+
+  uint32_t sum = uint32_t(vget_lane_s32(acc2, 0));
+  q15_t    lo  = vget_lane_s16(min4, 0);
+  q15_t    hi  = vget_lane_s16(max4, 0);
+
+  for (; n < blockSize; n++) {
+    q15_t val = pSrcB[n];
+
+    sum += uint32_t(q31_t(pSrcA[n]) * val);
+
+    if (val < lo)
+      lo = val;
+    if (val > hi)
+      hi = val;
+  }
+
+  *result = q31_t(sum);
+  *pMin   = lo;
+  *pMax   = hi;
+}
+
+#endif
@@ -2,10 +2,42 @@
 
 #include <stdint.h>
 #include "arm_math_rpi.h"
+#include "arm_math_simd.h"
 
-#define __SIMD32_TYPE int32_t
-#define __SIMD32(addr)        (*(__SIMD32_TYPE **) & (addr))
-#define _SIMD32_OFFSET(addr)  (*(__SIMD32_TYPE *)  (addr))
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__arm__) && !defined(__aarch64__)
+#include <sys/auxv.h>
+#if !defined(HWCAP_NEON)
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
+
+/*
+ * Pairs of q15 values are moved through memcpy rather than by casting the q15_t pointers to
+ * int32_t pointers, which breaks strict aliasing. The compiler turns these into single loads
+ * and stores.
+ */
+static inline q31_t read_q15x2(const q15_t * pQ15)
+{
+  q31_t val;
+  ::memcpy(&val, pQ15, sizeof(q31_t));
+  return val;
+}
+
+static inline q31_t read_q15x2_ia(const q15_t ** pQ15)
+{
+  q31_t val = read_q15x2(*pQ15);
+  *pQ15 += 2;
+  return val;
+}
+
+static inline void write_q15x2_ia(q15_t ** pQ15, q31_t value)
+{
+  ::memcpy(*pQ15, &value, sizeof(q31_t));
+  *pQ15 += 2;
+}
 
 #define __PKHBT(ARG1, ARG2, ARG3)      ( (((int32_t)(ARG1) <<  0) & (int32_t)0x0000FFFF) | \
                                          (((int32_t)(ARG2) << ARG3) & (int32_t)0xFFFF0000)  )
@@ -16,9 +48,9 @@ static uint32_t __SMLAD(
   uint32_t y,
   uint32_t sum)
   {
-    return ((uint32_t)(((((q31_t)x << 16) >> 16) * (((q31_t)y << 16) >> 16)) +
-                       ((((q31_t)x      ) >> 16) * (((q31_t)y      ) >> 16)) +
-                       ( ((q31_t)sum    )                                  )   ));
+    return ((uint32_t)((((q31_t)x << 16) >> 16) * (((q31_t)y << 16) >> 16)) +
+            (uint32_t)((((q31_t)x      ) >> 16) * (((q31_t)y      ) >> 16)) +
+            sum);
   }
 
 
@@ -31,21 +63,22 @@ static uint32_t __SMLADX(
   uint32_t y,
   uint32_t sum)
 {
-    return ((uint32_t)(((((q31_t)x << 16) >> 16) * (((q31_t)y      ) >> 16)) +
-                       ((((q31_t)x      ) >> 16) * (((q31_t)y << 16) >> 16)) +
-                       ( ((q31_t)sum    )                                  )   ));
+    return ((uint32_t)((((q31_t)x << 16) >> 16) * (((q31_t)y      ) >> 16)) +
+            (uint32_t)((((q31_t)x      ) >> 16) * (((q31_t)y << 16) >> 16)) +
+            sum);
 }
 
-void arm_fir_interpolate_q15(
+void arm_fir_interpolate_q15_scalar(
   const arm_fir_interpolate_instance_q15 * S,
   q15_t * pSrc,
   q15_t * pDst,
   uint32_t blockSize)
 {
   q15_t *pState = S->pState;                     /* State pointer                                            */
-  q15_t *pCoeffs = S->pCoeffs;                   /* Coefficient pointer                                      */
+  const q15_t *pCoeffs = S->pCoeffs;             /* Coefficient pointer                                      */
   q15_t *pStateCurnt;                            /* Points to the current sample of the state                */
-  q15_t *ptr1, *ptr2;                            /* Temporary pointers for state and coefficient buffers     */
+  q15_t *ptr1;                                   /* Temporary pointer for state buffer                       */
+  const q15_t *ptr2;                             /* Temporary pointer for coefficient buffer                 */
   q63_t sum;                                     /* Accumulator */
   q15_t x0, c0;                                  /* Temporary variables to hold state and coefficient values */
   uint32_t i, blkCnt, tapCnt;                    /* Loop counters                                            */
@@ -134,18 +167,18 @@ void arm_fir_interpolate_q15(
 
 }
 
-void arm_fir_fast_q15(
+void arm_fir_fast_q15_scalar(
   const arm_fir_instance_q15 * S,
   q15_t * pSrc,
   q15_t * pDst,
   uint32_t blockSize)
 {
   q15_t *pState = S->pState;                     /* State pointer */
-  q15_t *pCoeffs = S->pCoeffs;                   /* Coefficient pointer */
+  const q15_t *pCoeffs = S->pCoeffs;             /* Coefficient pointer */
   q15_t *pStateCurnt;                            /* Points to the current sample of the state */
   q31_t acc0, acc1, acc2, acc3;                  /* Accumulators */
-  q15_t *pb;                                     /* Temporary pointer for coefficient buffer */
-  q15_t *px;                                     /* Temporary q31 pointer for SIMD state buffer accesses */
+  const q15_t *pb;                               /* Temporary pointer for coefficient buffer */
+  const q15_t *px;                               /* Temporary q31 pointer for SIMD state buffer accesses */
   q31_t x0, x1, x2, c0;                          /* Temporary variables to hold SIMD state and coefficient values */
   uint32_t numTaps = S->numTaps;                 /* Number of taps in the filter */
   uint32_t tapCnt, blkCnt;                       /* Loop counters */
@@ -191,10 +224,10 @@ void arm_fir_fast_q15(
     pb = pCoeffs;
 
     /* Read the first two samples from the state buffer:  x[n-N], x[n-N-1] */
-    x0 = *__SIMD32(px)++;
+    x0 = read_q15x2_ia(&px);
 
     /* Read the third and forth samples from the state buffer: x[n-N-2], x[n-N-3] */
-    x2 = *__SIMD32(px)++;
+    x2 = read_q15x2_ia(&px);
 
     /* Loop over the number of taps.  Unroll by a factor of 4.      
      ** Repeat until we've computed numTaps-(numTaps%4) coefficients. */
@@ -203,7 +236,7 @@ void arm_fir_fast_q15(
     while(tapCnt > 0)
     {
       /* Read the first two coefficients using SIMD:  b[N] and b[N-1] coefficients */
-      c0 = *__SIMD32(pb)++;
+      c0 = read_q15x2_ia(&pb);
 
       /* acc0 +=  b[N] * x[n-N] + b[N-1] * x[n-N-1] */
       acc0 = __SMLAD(x0, c0, acc0);
@@ -219,7 +252,7 @@ void arm_fir_fast_q15(
 #endif
 
       /* Read state x[n-N-4], x[n-N-5] */
-      x0 = _SIMD32_OFFSET(px);
+      x0 = read_q15x2(px);
 
       /* acc1 +=  b[N] * x[n-N-1] + b[N-1] * x[n-N-2] */
       acc1 = __SMLADX(x1, c0, acc1);
@@ -235,13 +268,13 @@ void arm_fir_fast_q15(
       acc3 = __SMLADX(x1, c0, acc3);
 
       /* Read coefficients b[N-2], b[N-3] */
-      c0 = *__SIMD32(pb)++;
+      c0 = read_q15x2_ia(&pb);
 
       /* acc0 +=  b[N-2] * x[n-N-2] + b[N-3] * x[n-N-3] */
       acc0 = __SMLAD(x2, c0, acc0);
 
       /* Read state x[n-N-6], x[n-N-7] with offset */
-      x2 = _SIMD32_OFFSET(px + 2u);
+      x2 = read_q15x2(px + 2u);
 
       /* acc2 +=  b[N-2] * x[n-N-4] + b[N-3] * x[n-N-5] */
       acc2 = __SMLAD(x0, c0, acc2);
@@ -273,7 +306,7 @@ void arm_fir_fast_q15(
     {
 
       /* Read last two coefficients */
-      c0 = *__SIMD32(pb)++;
+      c0 = read_q15x2_ia(&pb);
 
       /* Perform the multiply-accumulates */
       acc0 = __SMLAD(x0, c0, acc0);
@@ -287,7 +320,7 @@ void arm_fir_fast_q15(
 #endif
 
       /* Read last state variables */
-      x0 = *__SIMD32(px);
+      x0 = read_q15x2(px);
 
       /* Perform the multiply-accumulates */
       acc1 = __SMLADX(x1, c0, acc1);
@@ -308,19 +341,19 @@ void arm_fir_fast_q15(
 
 #ifndef ARM_MATH_BIG_ENDIAN
 
-    *__SIMD32(pDst)++ =
-      __PKHBT(__SSAT((acc0 >> 15), 16), __SSAT((acc1 >> 15), 16), 16);
+    write_q15x2_ia(&pDst,
+      __PKHBT(__SSAT((acc0 >> 15), 16), __SSAT((acc1 >> 15), 16), 16));
 
-    *__SIMD32(pDst)++ =
-      __PKHBT(__SSAT((acc2 >> 15), 16), __SSAT((acc3 >> 15), 16), 16);
+    write_q15x2_ia(&pDst,
+      __PKHBT(__SSAT((acc2 >> 15), 16), __SSAT((acc3 >> 15), 16), 16));
 
 #else
 
-    *__SIMD32(pDst)++ =
-      __PKHBT(__SSAT((acc1 >> 15), 16), __SSAT((acc0 >> 15), 16), 16);
+    write_q15x2_ia(&pDst,
+      __PKHBT(__SSAT((acc1 >> 15), 16), __SSAT((acc0 >> 15), 16), 16));
 
-    *__SIMD32(pDst)++ =
-      __PKHBT(__SSAT((acc3 >> 15), 16), __SSAT((acc2 >> 15), 16), 16);
+    write_q15x2_ia(&pDst,
+      __PKHBT(__SSAT((acc3 >> 15), 16), __SSAT((acc2 >> 15), 16), 16));
 
 
 #endif /*      #ifndef ARM_MATH_BIG_ENDIAN       */
@@ -405,7 +438,65 @@ void arm_fir_fast_q15(
 
 }
 
-void arm_biquad_cascade_df1_q31(
+void arm_fir_window_q15_scalar(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t n, k;                                 /* Loop counters */
+  uint32_t acc0, acc1, acc2, acc3;               /* Accumulators, wrap in 32 bits like __SMLAD */
+  q31_t x0, x1, x2, x3, c0;                      /* State and coefficient values */
+
+  /* Four outputs at a time, each sample is loaded once and rotated through x0 ... x3 */
+  for (n = 0u; n + 4u <= blockSize; n += 4u)
+  {
+    const q15_t *px = pSrc + n;
+
+    acc0 = 0u;
+    acc1 = 0u;
+    acc2 = 0u;
+    acc3 = 0u;
+
+    x0 = px[0];
+    x1 = px[1];
+    x2 = px[2];
+
+    for (k = 0u; k < numTaps; k++)
+    {
+      c0 = pCoeffs[k];
+      x3 = px[k + 3u];
+
+      acc0 += (uint32_t) (x0 * c0);
+      acc1 += (uint32_t) (x1 * c0);
+      acc2 += (uint32_t) (x2 * c0);
+      acc3 += (uint32_t) (x3 * c0);
+
+      x0 = x1;
+      x1 = x2;
+      x2 = x3;
+    }
+
+    pDst[n + 0u] = (q15_t) (__SSAT(((q31_t) acc0 >> 15), 16));
+    pDst[n + 1u] = (q15_t) (__SSAT(((q31_t) acc1 >> 15), 16));
+    pDst[n + 2u] = (q15_t) (__SSAT(((q31_t) acc2 >> 15), 16));
+    pDst[n + 3u] = (q15_t) (__SSAT(((q31_t) acc3 >> 15), 16));
+  }
+
+  for (; n < blockSize; n++)
+  {
+    const q15_t *px = pSrc + n;
+
+    acc0 = 0u;
+    for (k = 0u; k < numTaps; k++)
+      acc0 += (uint32_t) ((q31_t) px[k] * pCoeffs[k]);
+
+    pDst[n] = (q15_t) (__SSAT(((q31_t) acc0 >> 15), 16));
+  }
+}
+
+void arm_biquad_cascade_df1_q31_scalar(
   const arm_biquad_casd_df1_inst_q31 * S,
   q31_t * pSrc,
   q31_t * pDst,
@@ -417,7 +508,7 @@ void arm_biquad_cascade_df1_q31(
   q31_t *pIn = pSrc;                             /*  input pointer initialization  */
   q31_t *pOut = pDst;                            /*  output pointer initialization */
   q31_t *pState = S->pState;                     /*  pState pointer initialization */
-  q31_t *pCoeffs = S->pCoeffs;                   /*  coeff pointer initialization  */
+  const q31_t *pCoeffs = S->pCoeffs;                  /*  coeff pointer initialization  */
   q31_t Xn1, Xn2, Yn1, Yn2;                      /*  Filter state variables        */
   q31_t b0, b1, b2, a1, a2;                      /*  Filter coefficients           */
   q31_t Xn;                                      /*  temporary input               */
@@ -500,7 +591,7 @@ void arm_biquad_cascade_df1_q31(
 
 }
 
-void arm_q15_to_q31(
+void arm_q15_to_q31_scalar(
   q15_t * pSrc,
   q31_t * pDst,
   uint32_t blockSize)
@@ -523,4 +614,162 @@ void arm_q15_to_q31(
 
 }
 
+void arm_dot_prod_min_max_q15_scalar(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax)
+{
+  uint32_t acc = 0U;
+  q15_t    min = 32767;
+  q15_t    max = -32768;
+
+  for (uint32_t n = 0U; n < blockSize; n++) {
+    q15_t val = pSrcB[n];
+
+    acc += uint32_t(q31_t(pSrcA[n]) * val);
+
+    if (val < min)
+      min = val;
+    if (val > max)
+      max = val;
+  }
+
+  *result = q31_t(acc);
+  *pMin   = min;
+  *pMax   = max;
+}
+
+/*
+ * Run time selection of the kernels. The scalar versions above are the reference, each SIMD
+ * backend produces bit identical output, tests/ArmMathTest.cpp checks this. The biquad is
+ * recursive from one sample to the next and is left scalar in every backend.
+ * ARM_MATH_BACKEND=scalar|neon|sse4|avx2 overrides the choice when the CPU supports it. NEON
+ * has yet to pass that test on ARM hardware, so it is only used when asked for.
+ */
+struct ARM_MATH_KERNELS {
+  const char* name;
+  void (*firInterpolate)(const arm_fir_interpolate_instance_q15*, q15_t*, q15_t*, uint32_t);
+  void (*firFast)(const arm_fir_instance_q15*, q15_t*, q15_t*, uint32_t);
+  void (*firWindow)(const q15_t*, uint16_t, const q15_t*, q15_t*, uint32_t);
+  void (*biquad)(const arm_biquad_casd_df1_inst_q31*, q31_t*, q31_t*, uint32_t);
+  void (*q15ToQ31)(q15_t*, q31_t*, uint32_t);
+  void (*dotProdMinMax)(const q15_t*, const q15_t*, uint32_t, q31_t*, q15_t*, q15_t*);
+};
+
+static const ARM_MATH_KERNELS SCALAR_KERNELS = {"scalar", arm_fir_interpolate_q15_scalar, arm_fir_fast_q15_scalar, arm_fir_window_q15_scalar, arm_biquad_cascade_df1_q31_scalar, arm_q15_to_q31_scalar, arm_dot_prod_min_max_q15_scalar};
+#if defined(ARM_MATH_NEON)
+static const ARM_MATH_KERNELS NEON_KERNELS   = {"neon",   arm_fir_interpolate_q15_neon,   arm_fir_fast_q15_neon,   arm_fir_window_q15_neon, arm_biquad_cascade_df1_q31_scalar, arm_q15_to_q31_neon, arm_dot_prod_min_max_q15_neon};
+#endif
+#if defined(ARM_MATH_SSE4)
+static const ARM_MATH_KERNELS SSE4_KERNELS   = {"sse4",   arm_fir_interpolate_q15_sse4,   arm_fir_fast_q15_sse4,   arm_fir_window_q15_sse4, arm_biquad_cascade_df1_q31_scalar, arm_q15_to_q31_sse4, arm_dot_prod_min_max_q15_sse4};
+#endif
+#if defined(ARM_MATH_AVX2)
+static const ARM_MATH_KERNELS AVX2_KERNELS   = {"avx2",   arm_fir_interpolate_q15_avx2,   arm_fir_fast_q15_avx2,   arm_fir_window_q15_avx2, arm_biquad_cascade_df1_q31_scalar, arm_q15_to_q31_avx2, arm_dot_prod_min_max_q15_avx2};
+#endif
+
+static const ARM_MATH_KERNELS* selectKernels()
+{
+  const ARM_MATH_KERNELS* supported[4U];
+  unsigned int n = 0U;
+
+  // Best first, the default is the first entry
+#if defined(ARM_MATH_AVX2) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    supported[n++] = &AVX2_KERNELS;
+#endif
+#if defined(ARM_MATH_SSE4) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.1"))
+    supported[n++] = &SSE4_KERNELS;
+#endif
+  supported[n++] = &SCALAR_KERNELS;
+#if defined(ARM_MATH_NEON) && defined(__aarch64__)
+  supported[n++] = &NEON_KERNELS;
+#elif defined(ARM_MATH_NEON) && defined(__arm__)
+  if ((::getauxval(AT_HWCAP) & HWCAP_NEON) != 0UL)
+    supported[n++] = &NEON_KERNELS;
+#endif
+
+  const char* name = ::getenv("ARM_MATH_BACKEND");
+  if (name != NULL) {
+    for (unsigned int i = 0U; i < n; i++) {
+      if (::strcmp(name, supported[i]->name) == 0)
+        return supported[i];
+    }
+  }
+
+  return supported[0U];
+}
+
+static const ARM_MATH_KERNELS& kernels()
+{
+  static const ARM_MATH_KERNELS* k = selectKernels();
+  return *k;
+}
+
+const char* arm_math_backend()
+{
+  return kernels().name;
+}
+
+void arm_fir_interpolate_q15(
+  const arm_fir_interpolate_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  kernels().firInterpolate(S, pSrc, pDst, blockSize);
+}
+
+void arm_fir_fast_q15(
+  const arm_fir_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  kernels().firFast(S, pSrc, pDst, blockSize);
+}
+
+void arm_fir_window_q15(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  kernels().firWindow(pCoeffs, numTaps, pSrc, pDst, blockSize);
+}
+
+void arm_biquad_cascade_df1_q31(
+  const arm_biquad_casd_df1_inst_q31 * S,
+  q31_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  kernels().biquad(S, pSrc, pDst, blockSize);
+}
+
+void arm_q15_to_q31(
+  q15_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  kernels().q15ToQ31(pSrc, pDst, blockSize);
+}
+
+void arm_dot_prod_min_max_q15(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax)
+{
+  kernels().dotProdMinMax(pSrcA, pSrcB, blockSize, result, pMin, pMax);
+}
+
 #endif
@@ -1,4 +1,5 @@
-#if defined(RPI)
+#if defined(RPI) && !defined(ARM_MATH_RPI_H)
+#define  ARM_MATH_RPI_H
 
 #include <cstddef>
 
@@ -12,14 +13,14 @@ typedef struct
     q15_t *pState;            /**< points to the state variable array. The array is of length numTaps+blockSize-1. 
 
 */
-    q15_t *pCoeffs;           /**< points to the coefficient array. The array is of length numTaps.*/
+    const q15_t *pCoeffs;     /**< points to the coefficient array. The array is of length numTaps.*/
   } arm_fir_instance_q15;
 
 typedef struct
   {
     uint8_t L;                      /**< upsample factor. */
     uint16_t phaseLength;           /**< length of each polyphase filter component. */
-    q15_t *pCoeffs;                 /**< points to the coefficient array. The array is of length L*phaseLength. */
+    const q15_t *pCoeffs;           /**< points to the coefficient array. The array is of length L*phaseLength. */
     q15_t *pState;                  /**< points to the state variable array. The array is of length blockSize+phaseLength-1. */
   } arm_fir_interpolate_instance_q15;
 
@@ -27,7 +28,7 @@ typedef struct
   {
     uint32_t numStages;      /**< number of 2nd order stages in the filter.  Overall order is 2*numStages. */
     q31_t *pState;           /**< Points to the array of state coefficients.  The array is of length 4*numStages. */
-    q31_t *pCoeffs;          /**< Points to the array of coefficients.  The array is of length 5*numStages. */
+    const q31_t *pCoeffs;    /**< Points to the array of coefficients.  The array is of length 5*numStages. */
     uint8_t postShift;       /**< Additional shift, in bits, applied to each output sample. */
   } arm_biquad_casd_df1_inst_q31;
 
@@ -57,6 +58,21 @@ typedef struct
   q15_t * pDst,
   uint32_t blockSize);
 
+/**
+   * @brief Q15 FIR filter over a window kept by the caller, the arithmetic is that of arm_fir_fast_q15.
+   * @param[in]  pCoeffs    points to the coefficients, numTaps of them.
+   * @param[in]  numTaps    number of filter coefficients, an even number.
+   * @param[in]  pSrc       points to numTaps - 1 samples of history followed by the block of input data.
+   * @param[out] pDst       points to the block of output data.
+   * @param[in]  blockSize  number of samples to process.
+   */
+  void arm_fir_window_q15(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize);
+
 /**
    * @brief Processing function for the Q31 Biquad cascade filter
    * @param[in]  S          points to an instance of the Q31 Biquad cascade structure.
@@ -81,6 +97,28 @@ typedef struct
   q31_t * pDst,
   uint32_t blockSize);
 
+/**
+   * @brief Q15 dot product that also finds the smallest and largest of the second vector in the same pass.
+   * @param[in]  pSrcA      points to the first input vector.
+   * @param[in]  pSrcB      points to the second input vector.
+   * @param[in]  blockSize  number of samples in each vector.
+   * @param[out] result     sum of the products, wrapping in 32 bits.
+   * @param[out] pMin       smallest value of pSrcB.
+   * @param[out] pMax       largest value of pSrcB.
+   */
+  void arm_dot_prod_min_max_q15(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax);
+
+/**
+   * @brief  Name of the kernel set picked for this CPU, "scalar", "neon", "sse4" or "avx2".
+   */
+  const char* arm_math_backend();
+
 #define __SSAT(x, y)  ((x>32767)  ? 32767 : ((x < -32768) ? -32768 : x))
 
 #endif
@@ -0,0 +1,60 @@
+/*
+ *   SIMD backends of the arm_math_rpi kernels
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(ARM_MATH_SIMD_H)
+#define  ARM_MATH_SIMD_H
+
+#include <stdint.h>
+
+#include "arm_math_rpi.h"
+
+// The portable reference kernels, every backend must match these bit for bit
+void arm_fir_interpolate_q15_scalar(const arm_fir_interpolate_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_fast_q15_scalar(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_window_q15_scalar(const q15_t * pCoeffs, uint16_t numTaps, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_biquad_cascade_df1_q31_scalar(const arm_biquad_casd_df1_inst_q31 * S, q31_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_q15_to_q31_scalar(q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_dot_prod_min_max_q15_scalar(const q15_t * pSrcA, const q15_t * pSrcB, uint32_t blockSize, q31_t * result, q15_t * pMin, q15_t * pMax);
+
+// Each backend lives in its own file built with the matching instruction set flags, the build
+// defines ARM_MATH_NEON, ARM_MATH_SSE4 or ARM_MATH_AVX2 for those it compiles
+#if defined(ARM_MATH_NEON)
+void arm_fir_interpolate_q15_neon(const arm_fir_interpolate_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_fast_q15_neon(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_window_q15_neon(const q15_t * pCoeffs, uint16_t numTaps, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_q15_to_q31_neon(q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_dot_prod_min_max_q15_neon(const q15_t * pSrcA, const q15_t * pSrcB, uint32_t blockSize, q31_t * result, q15_t * pMin, q15_t * pMax);
+#endif
+
+#if defined(ARM_MATH_SSE4)
+void arm_fir_interpolate_q15_sse4(const arm_fir_interpolate_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_fast_q15_sse4(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_window_q15_sse4(const q15_t * pCoeffs, uint16_t numTaps, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_q15_to_q31_sse4(q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_dot_prod_min_max_q15_sse4(const q15_t * pSrcA, const q15_t * pSrcB, uint32_t blockSize, q31_t * result, q15_t * pMin, q15_t * pMax);
+#endif
+
+#if defined(ARM_MATH_AVX2)
+void arm_fir_interpolate_q15_avx2(const arm_fir_interpolate_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_fast_q15_avx2(const arm_fir_instance_q15 * S, q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_fir_window_q15_avx2(const q15_t * pCoeffs, uint16_t numTaps, const q15_t * pSrc, q15_t * pDst, uint32_t blockSize);
+void arm_q15_to_q31_avx2(q15_t * pSrc, q31_t * pDst, uint32_t blockSize);
+void arm_dot_prod_min_max_q15_avx2(const q15_t * pSrcA, const q15_t * pSrcB, uint32_t blockSize, q31_t * result, q15_t * pMin, q15_t * pMax);
+#endif
+
+#endif
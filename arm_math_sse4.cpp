@@ -0,0 +1,205 @@
+/*
+ *   SSE4.1 backend of the arm_math_rpi kernels
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if defined(RPI) && defined(ARM_MATH_SSE4)
+
+#include "arm_math_simd.h"
+
+#include <smmintrin.h>
+
+#include <cstring>
+
+void arm_fir_interpolate_q15_sse4(
+  const arm_fir_interpolate_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  const q15_t* pCoeffs  = S->pCoeffs;
+  uint32_t     L        = S->L;
+  uint32_t     phaseLen = S->phaseLength;
+
+  ::memcpy(S->pState + phaseLen - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  // The coefficients of one tap for every phase are adjacent, so four phases are summed
+  // together, in 64 bits like the reference
+  for (uint32_t n = 0U; n < blockSize; n++) {
+    const q15_t* px = S->pState + n;
+
+    uint32_t j = 0U;
+    for (; j + 4U <= L; j += 4U) {
+      __m128i acc0 = _mm_setzero_si128();
+      __m128i acc1 = _mm_setzero_si128();
+
+      for (uint32_t t = 0U; t < phaseLen; t++) {
+        __m128i c = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(pCoeffs + j + t * L)));
+        __m128i p = _mm_mullo_epi32(c, _mm_set1_epi32(px[t]));
+
+        acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(p));
+        acc1 = _mm_add_epi64(acc1, _mm_cvtepi32_epi64(_mm_srli_si128(p, 8)));
+      }
+
+      q63_t sum[4U];
+      _mm_storeu_si128((__m128i*)(sum + 0U), acc0);
+      _mm_storeu_si128((__m128i*)(sum + 2U), acc1);
+
+      // Phases are written last first
+      for (uint32_t m = 0U; m < 4U; m++)
+        pDst[L - 1U - j - m] = q15_t(__SSAT((sum[m] >> 15), 16));
+    }
+
+    for (; j < L; j++) {
+      q63_t sum = 0;
+      for (uint32_t t = 0U; t < phaseLen; t++)
+        sum += q31_t(px[t]) * pCoeffs[j + t * L];
+
+      pDst[L - 1U - j] = q15_t(__SSAT((sum >> 15), 16));
+    }
+
+    pDst += L;
+  }
+
+  ::memmove(S->pState, S->pState + blockSize, (phaseLen - 1U) * sizeof(q15_t));
+}
+
+void arm_fir_window_q15_sse4(
+  const q15_t * pCoeffs,
+  uint16_t numTaps,
+  const q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  // Eight outputs at a time. Interleaving the state with itself one sample on pairs each
+  // sample with its successor, which PMADDWD multiplies against a pair of taps. The sums wrap
+  // in 32 bits exactly as the reference does.
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    const q15_t* px = pSrc + n;
+
+    __m128i accLo = _mm_setzero_si128();
+    __m128i accHi = _mm_setzero_si128();
+
+    for (uint32_t k = 0U; k < numTaps; k += 2U) {
+      int32_t pair;
+      ::memcpy(&pair, pCoeffs + k, sizeof(int32_t));
+      __m128i c = _mm_set1_epi32(pair);
+
+      __m128i a = _mm_loadu_si128((const __m128i*)(px + k));
+      __m128i b = _mm_loadu_si128((const __m128i*)(px + k + 1U));
+
+      accLo = _mm_add_epi32(accLo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+      accHi = _mm_add_epi32(accHi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+    }
+
+    accLo = _mm_srai_epi32(accLo, 15);
+    accHi = _mm_srai_epi32(accHi, 15);
+    _mm_storeu_si128((__m128i*)(pDst + n), _mm_packs_epi32(accLo, accHi));
+  }
+
+  for (; n < blockSize; n++) {
+    const q15_t* px = pSrc + n;
+
+    uint32_t acc = 0U;
+    for (uint32_t k = 0U; k < numTaps; k++)
+      acc += uint32_t(q31_t(px[k]) * pCoeffs[k]);
+
+    q31_t res = q31_t(acc) >> 15;
+    pDst[n] = q15_t(__SSAT(res, 16));
+  }
+}
+
+void arm_fir_fast_q15_sse4(
+  const arm_fir_instance_q15 * S,
+  q15_t * pSrc,
+  q15_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t numTaps = S->numTaps;
+
+  ::memcpy(S->pState + numTaps - 1U, pSrc, blockSize * sizeof(q15_t));
+
+  arm_fir_window_q15_sse4(S->pCoeffs, S->numTaps, S->pState, pDst, blockSize);
+
+  ::memmove(S->pState, S->pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+void arm_q15_to_q31_sse4(
+  q15_t * pSrc,
+  q31_t * pDst,
+  uint32_t blockSize)
+{
+  uint32_t n = 0U;
+  for (; n + 4U <= blockSize; n += 4U) {
+    __m128i x = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(pSrc + n)));
+    _mm_storeu_si128((__m128i*)(pDst + n), _mm_slli_epi32(x, 16));
+  }
+
+  for (; n < blockSize; n++)
+    pDst[n] = q31_t(uint32_t(pSrc[n]) << 16);
+}
+
+
+void arm_dot_prod_min_max_q15_sse4(
+  const q15_t * pSrcA,
+  const q15_t * pSrcB,
+  uint32_t blockSize,
+  q31_t * result,
+  q15_t * pMin,
+  q15_t * pMax)
+{
+  __m128i acc = _mm_setzero_si128();
+  __m128i min = _mm_set1_epi16(32767);
+  __m128i max = _mm_set1_epi16(-32768);
+
+  // Eight at a time, PMADDWD wraps in 32 bits like the reference
+  uint32_t n = 0U;
+  for (; n + 8U <= blockSize; n += 8U) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(pSrcA + n));
+    __m128i b = _mm_loadu_si128((const __m128i*)(pSrcB + n));
+
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    min = _mm_min_epi16(min, b);
+    max = _mm_max_epi16(max, b);
+  }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+  uint32_t sum = uint32_t(_mm_cvtsi128_si32(acc));
+
+  // PHMINPOSUW works on unsigned words, flipping the sign bit orders them as signed and flipping
+  // the other bits as well turns the maximum into the minimum
+  q15_t lo = q15_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(min, _mm_set1_epi16(-32768)))) ^ 0x8000);
+  q15_t hi = q15_t(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(max, _mm_set1_epi16(32767)))) ^ 0x7FFF);
+
+  for (; n < blockSize; n++) {
+    q15_t val = pSrcB[n];
+
+    sum += uint32_t(q31_t(pSrcA[n]) * val);
+
+    if (val < lo)
+      lo = val;
+    if (val > hi)
+      hi = val;
+  }
+
+  *result = q31_t(sum);
+  *pMin   = lo;
+  *pMax   = hi;
+}
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ *   Test of the 4FSK table modulator against the interpolating filter it replaced
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "TXFilters.h"
+
+#include <cstdio>
+#include <cstring>
+
+const uint32_t TEST_BYTES = 5000U;
+
+const uint16_t MAX_SPS = 10U;
+
+// The symbols before the newest that the nine symbol table still sees
+const uint16_t HISTORY_SYMBOLS = TX_4FSK_GROUPS * TX_4FSK_GROUP_SYMBOLS - 1U;
+
+static uint8_t data[TEST_BYTES];
+
+// The filter path the transmitters had, one arm_fir_interpolate_q15 per byte from a zeroed state,
+// first given count symbols at the level the table's power on history stands for
+template <uint16_t SPS, size_t N>
+static void filterPath(const std::array<int16_t, N>& taps, q15_t a, q15_t b, q15_t c, q15_t d, uint16_t count, q15_t* out)
+{
+  q15_t state[N / SPS + 4U - 1U];
+  ::memset(state, 0x00U, sizeof(state));
+
+  arm_fir_interpolate_instance_q15 filter;
+  filter.L           = SPS;
+  filter.phaseLength = N / SPS;
+  filter.pCoeffs     = taps.data();
+  filter.pState      = state;
+
+  // By dibit, 00 is -1, 01 is -3, 10 is +1 and 11 is +3
+  const q15_t level[4U] = {c, d, b, a};
+
+  q15_t in[4U];
+  q15_t discard[4U * SPS];
+  for (uint16_t i = 0U; i < count; i++) {
+    in[0U] = c;
+    ::arm_fir_interpolate_q15(&filter, in, discard, 1U);
+  }
+
+  for (uint32_t i = 0U; i < TEST_BYTES; i++) {
+    uint8_t byte = data[i];
+    for (uint8_t j = 0U; j < 4U; j++, byte <<= 2)
+      in[j] = level[byte >> 6];
+
+    ::arm_fir_interpolate_q15(&filter, in, out + i * 4U * SPS, 4U);
+  }
+}
+
+// From power on, in runs of the lengths the transmitters hand over
+template <uint16_t SPS>
+static void tablePath(const q31_t* table, q15_t* out)
+{
+  C4FSKTX<SPS> modulator(table);
+
+  uint32_t pos = 0U;
+  while (pos < TEST_BYTES) {
+    uint32_t n = 1U + (pos % TX_4FSK_BLOCK_BYTES);
+    if (n > TEST_BYTES - pos)
+      n = TEST_BYTES - pos;
+
+    modulator.modulate(data + pos, uint16_t(n), out + pos * 4U * SPS);
+    pos += n;
+  }
+}
+
+// The low pass or sinc filter the P25 and NXDN transmitters run next, a block at a time
+static void postFilter(const q15_t* coeffs, uint16_t numTaps, uint16_t sps, q15_t* in, q15_t* out)
+{
+  static q15_t state[32U + 4U * MAX_SPS * TX_4FSK_BLOCK_BYTES - 1U];
+  ::memset(state, 0x00U, sizeof(state));
+
+  arm_fir_instance_q15 filter;
+  filter.numTaps = numTaps;
+  filter.pState  = state;
+  filter.pCoeffs = coeffs;
+
+  const uint32_t block  = 4U * sps * TX_4FSK_BLOCK_BYTES;
+  const uint32_t length = TEST_BYTES * 4U * sps;
+  for (uint32_t pos = 0U; pos < length; pos += block)
+    ::arm_fir_fast_q15(&filter, in + pos, out + pos, length - pos < block ? length - pos : block);
+}
+
+static uint32_t firstDifference(const q15_t* a, const q15_t* b, uint32_t length)
+{
+  for (uint32_t i = 0U; i < length; i++) {
+    if (a[i] != b[i])
+      return i;
+  }
+
+  return length;
+}
+
+// The table output against the filter given the power on history, which must be identical, and
+// against the filter from silence, which may differ only while that history is in the filter
+template <uint16_t SPS, size_t N>
+static bool testMode(const char* name, const std::array<int16_t, N>& taps, const q31_t* table, q15_t a, q15_t b, q15_t c, q15_t d, const q15_t* post, uint16_t postLen)
+{
+  static q15_t primed[TEST_BYTES * 4U * MAX_SPS];
+  static q15_t silence[TEST_BYTES * 4U * MAX_SPS];
+  static q15_t output[TEST_BYTES * 4U * MAX_SPS];
+  static q15_t filtered[TEST_BYTES * 4U * MAX_SPS];
+
+  const uint32_t length = TEST_BYTES * 4U * SPS;
+
+  filterPath<SPS>(taps, a, b, c, d, HISTORY_SYMBOLS, primed);
+  filterPath<SPS>(taps, a, b, c, d, 0U, silence);
+  tablePath<SPS>(table, output);
+
+  uint32_t settle = HISTORY_SYMBOLS * SPS;
+
+  if (post != NULL) {
+    postFilter(post, postLen, SPS, primed, filtered);
+    ::memcpy(primed, filtered, length * sizeof(q15_t));
+
+    postFilter(post, postLen, SPS, silence, filtered);
+    ::memcpy(silence, filtered, length * sizeof(q15_t));
+
+    postFilter(post, postLen, SPS, output, filtered);
+    ::memcpy(output, filtered, length * sizeof(q15_t));
+
+    settle += postLen - 1U;
+  }
+
+  uint32_t first = firstDifference(output, primed, length);
+  bool identical = first == length;
+  if (identical)
+    ::printf("%-7s table against filter, %u random bytes from power on: identical\n", name, TEST_BYTES);
+  else
+    ::printf("%-7s table against filter, %u random bytes from power on: DIFFERS from sample %u, %d against %d\n", name, TEST_BYTES, first, output[first], primed[first]);
+
+  first = firstDifference(output + settle, silence + settle, length - settle);
+  bool settled = first == length - settle;
+  if (settled)
+    ::printf("%-7s table against filter from silence: identical after the first %u samples\n", name, settle);
+  else
+    ::printf("%-7s table against filter from silence: DIFFERS from sample %u, %d against %d\n", name, settle + first, output[settle + first], silence[settle + first]);
+
+  return identical && settled;
+}
+
+int main()
+{
+  uint32_t seed = 1U;
+  for (uint32_t i = 0U; i < TEST_BYTES; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    data[i] = uint8_t(seed >> 24);
+  }
+
+  ::printf("DSP kernels: %s\n", ::arm_math_backend());
+
+  bool ok = true;
+
+  ok = testMode<DMR_RADIO_SYMBOL_LENGTH>("DMR", DMR_RRC_0_2_FILTER, DMR_MOD_TABLE.data(), DMR_LEVELA, DMR_LEVELB, DMR_LEVELC, DMR_LEVELD, NULL, 0U) && ok;
+  ok = testMode<YSF_RADIO_SYMBOL_LENGTH>("YSF HI", YSF_RRC_0_2_FILTER, YSF_MOD_TABLE_HI.data(), YSF_LEVELA_HI, YSF_LEVELB_HI, YSF_LEVELC_HI, YSF_LEVELD_HI, NULL, 0U) && ok;
+  ok = testMode<YSF_RADIO_SYMBOL_LENGTH>("YSF LO", YSF_RRC_0_2_FILTER, YSF_MOD_TABLE_LO.data(), YSF_LEVELA_LO, YSF_LEVELB_LO, YSF_LEVELC_LO, YSF_LEVELD_LO, NULL, 0U) && ok;
+  ok = testMode<P25_RADIO_SYMBOL_LENGTH>("P25", P25_RC_0_2_FILTER, P25_MOD_TABLE.data(), P25_LEVELA, P25_LEVELB, P25_LEVELC, P25_LEVELD, P25_LOWPASS_FILTER, P25_LOWPASS_FILTER_LEN) && ok;
+  ok = testMode<NXDN_RADIO_SYMBOL_LENGTH>("NXDN", NXDN_RRC_0_2_FILTER, NXDN_MOD_TABLE.data(), NXDN_LEVELA, NXDN_LEVELB, NXDN_LEVELC, NXDN_LEVELD, NXDN_SINC_FILTER, NXDN_SINC_FILTER_LEN) && ok;
+
+  return ok ? 0 : 1;
+}
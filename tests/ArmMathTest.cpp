@@ -0,0 +1,344 @@
+/*
+ *   Bit exactness test and benchmark of the arm_math_rpi backends
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "arm_math_simd.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#if defined(__arm__) && !defined(__aarch64__)
+#include <sys/auxv.h>
+#if !defined(HWCAP_NEON)
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
+
+// Every backend is run whether or not the dispatch would pick it, so NEON is checked here before
+// it is trusted by default. The biquad is scalar in every backend and is not listed.
+struct BACKEND {
+  const char* name;
+  void (*firInterpolate)(const arm_fir_interpolate_instance_q15*, q15_t*, q15_t*, uint32_t);
+  void (*firFast)(const arm_fir_instance_q15*, q15_t*, q15_t*, uint32_t);
+  void (*firWindow)(const q15_t*, uint16_t, const q15_t*, q15_t*, uint32_t);
+  void (*q15ToQ31)(q15_t*, q31_t*, uint32_t);
+  void (*dotProdMinMax)(const q15_t*, const q15_t*, uint32_t, q31_t*, q15_t*, q15_t*);
+};
+
+static const BACKEND SCALAR = {"scalar", arm_fir_interpolate_q15_scalar, arm_fir_fast_q15_scalar, arm_fir_window_q15_scalar, arm_q15_to_q31_scalar, arm_dot_prod_min_max_q15_scalar};
+
+const unsigned int MAX_BACKENDS = 4U;
+
+static unsigned int getBackends(const BACKEND** backends)
+{
+  unsigned int n = 0U;
+
+  backends[n++] = &SCALAR;
+
+#if defined(ARM_MATH_SSE4) && (defined(__x86_64__) || defined(__i386__))
+  static const BACKEND SSE4 = {"sse4", arm_fir_interpolate_q15_sse4, arm_fir_fast_q15_sse4, arm_fir_window_q15_sse4, arm_q15_to_q31_sse4, arm_dot_prod_min_max_q15_sse4};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.1"))
+    backends[n++] = &SSE4;
+  else
+    ::printf("sse4: not supported by this CPU, skipped\n");
+#endif
+#if defined(ARM_MATH_AVX2) && (defined(__x86_64__) || defined(__i386__))
+  static const BACKEND AVX2 = {"avx2", arm_fir_interpolate_q15_avx2, arm_fir_fast_q15_avx2, arm_fir_window_q15_avx2, arm_q15_to_q31_avx2, arm_dot_prod_min_max_q15_avx2};
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    backends[n++] = &AVX2;
+  else
+    ::printf("avx2: not supported by this CPU, skipped\n");
+#endif
+#if defined(ARM_MATH_NEON)
+  static const BACKEND NEON = {"neon", arm_fir_interpolate_q15_neon, arm_fir_fast_q15_neon, arm_fir_window_q15_neon, arm_q15_to_q31_neon, arm_dot_prod_min_max_q15_neon};
+#if defined(__aarch64__)
+  backends[n++] = &NEON;
+#else
+  if ((::getauxval(AT_HWCAP) & HWCAP_NEON) != 0UL)
+    backends[n++] = &NEON;
+  else
+    ::printf("neon: not supported by this CPU, skipped\n");
+#endif
+#endif
+
+  return n;
+}
+
+const uint32_t MAX_BLOCK  = 512U;
+const uint32_t MAX_TAPS   = 128U;
+const uint32_t MAX_L      = 10U;
+const uint32_t MAX_PHASE  = 16U;
+const uint32_t CALLS      = 3U;
+
+const uint32_t TAPS[]   = {2U, 4U, 6U, 12U, 42U, 82U, 114U, 128U};
+const uint32_t BLOCKS[] = {1U, 2U, 3U, 4U, 5U, 7U, 8U, 9U, 15U, 16U, 17U, 31U, 64U, 100U, 480U};
+const uint32_t LS[]     = {1U, 2U, 3U, 4U, 5U, 8U, 10U};
+const uint32_t PHASES[] = {1U, 2U, 3U, 8U, 9U, 16U};
+
+#define COUNT(x) (sizeof(x) / sizeof(x[0U]))
+
+enum INPUT {
+  INPUT_RANDOM,
+  INPUT_SATURATING
+};
+
+static uint32_t seed = 1U;
+
+static q15_t value(INPUT input)
+{
+  seed = seed * 1664525U + 1013904223U;
+
+  // Only the extremes, so every sum and every saturation path is driven as hard as it goes
+  if (input == INPUT_SATURATING)
+    return (seed & 0x80000000U) != 0U ? q15_t(32767) : q15_t(-32768);
+
+  return q15_t(seed >> 16);
+}
+
+static void fill(q15_t* data, uint32_t length, INPUT input)
+{
+  for (uint32_t i = 0U; i < length; i++)
+    data[i] = value(input);
+}
+
+static unsigned int failures = 0U;
+
+static void check(bool ok, const char* backend, const char* kernel, INPUT input, uint32_t a, uint32_t b)
+{
+  if (ok)
+    return;
+
+  if (failures < 20U)
+    ::printf("%s: %s differs from scalar on %s input, %u/%u\n", backend, kernel, input == INPUT_RANDOM ? "random" : "saturating", a, b);
+
+  failures++;
+}
+
+// Runs a few calls in a row so the state kept between calls is checked as well
+static void testFirFast(const BACKEND& backend, INPUT input)
+{
+  for (unsigned int t = 0U; t < COUNT(TAPS); t++) {
+    for (unsigned int b = 0U; b < COUNT(BLOCKS); b++) {
+      uint32_t taps  = TAPS[t];
+      uint32_t block = BLOCKS[b];
+
+      q15_t coeffs[MAX_TAPS];
+      fill(coeffs, taps, input);
+
+      q15_t refState[MAX_TAPS + MAX_BLOCK] = {0};
+      q15_t state[MAX_TAPS + MAX_BLOCK]    = {0};
+      arm_fir_instance_q15 ref = {uint16_t(taps), refState, coeffs};
+      arm_fir_instance_q15 fir = {uint16_t(taps), state, coeffs};
+
+      bool ok = true;
+      for (uint32_t c = 0U; c < CALLS; c++) {
+        q15_t in[MAX_BLOCK], in2[MAX_BLOCK], refOut[MAX_BLOCK], out[MAX_BLOCK];
+        fill(in, block, input);
+        ::memcpy(in2, in, block * sizeof(q15_t));
+
+        SCALAR.firFast(&ref, in, refOut, block);
+        backend.firFast(&fir, in2, out, block);
+
+        ok = ok && ::memcmp(refOut, out, block * sizeof(q15_t)) == 0;
+        ok = ok && ::memcmp(refState, state, (taps - 1U) * sizeof(q15_t)) == 0;
+      }
+
+      check(ok, backend.name, "arm_fir_fast_q15", input, taps, block);
+    }
+  }
+}
+
+static void testFirWindow(const BACKEND& backend, INPUT input)
+{
+  for (unsigned int t = 0U; t < COUNT(TAPS); t++) {
+    for (unsigned int b = 0U; b < COUNT(BLOCKS); b++) {
+      uint32_t taps  = TAPS[t];
+      uint32_t block = BLOCKS[b];
+
+      q15_t coeffs[MAX_TAPS];
+      fill(coeffs, taps, input);
+
+      q15_t in[MAX_TAPS + MAX_BLOCK];
+      fill(in, taps - 1U + block, input);
+
+      q15_t refOut[MAX_BLOCK], out[MAX_BLOCK];
+      SCALAR.firWindow(coeffs, uint16_t(taps), in, refOut, block);
+      backend.firWindow(coeffs, uint16_t(taps), in, out, block);
+
+      check(::memcmp(refOut, out, block * sizeof(q15_t)) == 0, backend.name, "arm_fir_window_q15", input, taps, block);
+    }
+  }
+}
+
+static void testFirInterpolate(const BACKEND& backend, INPUT input)
+{
+  for (unsigned int l = 0U; l < COUNT(LS); l++) {
+    for (unsigned int p = 0U; p < COUNT(PHASES); p++) {
+      for (unsigned int b = 0U; b < COUNT(BLOCKS); b++) {
+        uint32_t L     = LS[l];
+        uint32_t phase = PHASES[p];
+        uint32_t block = BLOCKS[b];
+
+        q15_t coeffs[MAX_L * MAX_PHASE];
+        fill(coeffs, L * phase, input);
+
+        q15_t refState[MAX_PHASE + MAX_BLOCK] = {0};
+        q15_t state[MAX_PHASE + MAX_BLOCK]    = {0};
+        arm_fir_interpolate_instance_q15 ref = {uint8_t(L), uint16_t(phase), coeffs, refState};
+        arm_fir_interpolate_instance_q15 fir = {uint8_t(L), uint16_t(phase), coeffs, state};
+
+        bool ok = true;
+        for (uint32_t c = 0U; c < CALLS; c++) {
+          q15_t in[MAX_BLOCK], in2[MAX_BLOCK], refOut[MAX_L * MAX_BLOCK], out[MAX_L * MAX_BLOCK];
+          fill(in, block, input);
+          ::memcpy(in2, in, block * sizeof(q15_t));
+
+          SCALAR.firInterpolate(&ref, in, refOut, block);
+          backend.firInterpolate(&fir, in2, out, block);
+
+          ok = ok && ::memcmp(refOut, out, L * block * sizeof(q15_t)) == 0;
+          ok = ok && ::memcmp(refState, state, (phase - 1U) * sizeof(q15_t)) == 0;
+        }
+
+        check(ok, backend.name, "arm_fir_interpolate_q15", input, L * 100U + phase, block);
+      }
+    }
+  }
+}
+
+static void testQ15ToQ31(const BACKEND& backend, INPUT input)
+{
+  for (unsigned int b = 0U; b < COUNT(BLOCKS); b++) {
+    uint32_t block = BLOCKS[b];
+
+    q15_t in[MAX_BLOCK];
+    fill(in, block, input);
+
+    q31_t refOut[MAX_BLOCK], out[MAX_BLOCK];
+    SCALAR.q15ToQ31(in, refOut, block);
+    backend.q15ToQ31(in, out, block);
+
+    check(::memcmp(refOut, out, block * sizeof(q31_t)) == 0, backend.name, "arm_q15_to_q31", input, 0U, block);
+  }
+}
+
+static void testDotProdMinMax(const BACKEND& backend, INPUT input)
+{
+  for (unsigned int b = 0U; b < COUNT(BLOCKS); b++) {
+    uint32_t block = BLOCKS[b];
+
+    q15_t a[MAX_BLOCK], v[MAX_BLOCK];
+    fill(a, block, input);
+    fill(v, block, input);
+
+    q31_t refResult = 0, result = 0;
+    q15_t refMin = 0, refMax = 0, min = 0, max = 0;
+    SCALAR.dotProdMinMax(a, v, block, &refResult, &refMin, &refMax);
+    backend.dotProdMinMax(a, v, block, &result, &min, &max);
+
+    check(refResult == result && refMin == min && refMax == max, backend.name, "arm_dot_prod_min_max_q15", input, 0U, block);
+  }
+}
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1E-9;
+}
+
+// The sizes the modem uses: the 42 tap RRC, the 114 tap NXDN filter through the fused FIR, the
+// TX interpolators at 5 times and 9 taps per phase, an RX block and the 4FSK sync correlators
+const uint32_t BENCH_BLOCK  = 480U;
+const uint32_t BENCH_CALLS  = 4000U;
+const uint32_t BENCH_SYNC   = 120U;
+
+static void bench(const BACKEND& backend)
+{
+  static q15_t coeffs[MAX_TAPS], in[MAX_TAPS + MAX_BLOCK], out[MAX_L * MAX_BLOCK];
+  static q15_t state[MAX_TAPS + MAX_BLOCK];
+  static q31_t out31[MAX_BLOCK];
+
+  seed = 1U;
+  fill(coeffs, MAX_TAPS, INPUT_RANDOM);
+  fill(in, MAX_TAPS + MAX_BLOCK, INPUT_RANDOM);
+  ::memset(state, 0x00, sizeof(state));
+
+  double ns[5U];
+
+  arm_fir_instance_q15 fir = {42U, state, coeffs};
+  double start = now();
+  for (uint32_t i = 0U; i < BENCH_CALLS; i++)
+    backend.firFast(&fir, in, out, BENCH_BLOCK);
+  ns[0U] = (now() - start) * 1E9 / double(BENCH_CALLS * BENCH_BLOCK);
+
+  start = now();
+  for (uint32_t i = 0U; i < BENCH_CALLS; i++)
+    backend.firWindow(coeffs, 114U, in, out, BENCH_BLOCK);
+  ns[1U] = (now() - start) * 1E9 / double(BENCH_CALLS * BENCH_BLOCK);
+
+  arm_fir_interpolate_instance_q15 interp = {5U, 9U, coeffs, state};
+  start = now();
+  for (uint32_t i = 0U; i < BENCH_CALLS; i++)
+    backend.firInterpolate(&interp, in, out, BENCH_BLOCK / 5U);
+  ns[2U] = (now() - start) * 1E9 / double(BENCH_CALLS * BENCH_BLOCK);
+
+  start = now();
+  for (uint32_t i = 0U; i < BENCH_CALLS; i++)
+    backend.q15ToQ31(in, out31, BENCH_BLOCK);
+  ns[3U] = (now() - start) * 1E9 / double(BENCH_CALLS * BENCH_BLOCK);
+
+  q31_t corr = 0;
+  q15_t min = 0, max = 0;
+  start = now();
+  for (uint32_t i = 0U; i < BENCH_CALLS * 4U; i++)
+    backend.dotProdMinMax(coeffs, in + (i & 63U), BENCH_SYNC, &corr, &min, &max);
+  ns[4U] = (now() - start) * 1E9 / double(BENCH_CALLS * 4U);
+
+  ::printf("%-8s %14.2f %14.2f %14.2f %14.2f %14.1f\n", backend.name, ns[0U], ns[1U], ns[2U], ns[3U], ns[4U]);
+}
+
+int main()
+{
+  const BACKEND* backends[MAX_BACKENDS];
+  unsigned int n = getBackends(backends);
+
+  for (unsigned int i = 1U; i < n; i++) {
+    unsigned int before = failures;
+
+    const INPUT inputs[] = {INPUT_RANDOM, INPUT_SATURATING};
+    for (unsigned int j = 0U; j < COUNT(inputs); j++) {
+      testFirFast(*backends[i], inputs[j]);
+      testFirWindow(*backends[i], inputs[j]);
+      testFirInterpolate(*backends[i], inputs[j]);
+      testQ15ToQ31(*backends[i], inputs[j]);
+      testDotProdMinMax(*backends[i], inputs[j]);
+    }
+
+    ::printf("%s: %s\n", backends[i]->name, failures == before ? "bit exact with scalar" : "MISMATCH");
+  }
+
+  ::printf("\n%-8s %14s %14s %14s %14s %14s\n", "", "fir_fast 42", "fir_window 114", "interpolate 5", "q15_to_q31", "dot_prod 120");
+  ::printf("%-8s %14s %14s %14s %14s %14s\n", "", "ns/sample", "ns/sample", "ns/sample", "ns/sample", "ns/call");
+  for (unsigned int i = 0U; i < n; i++)
+    bench(*backends[i]);
+
+  return failures == 0U ? 0 : 1;
+}
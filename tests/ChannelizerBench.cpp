@@ -0,0 +1,151 @@
+/*
+ *   Benchmark of the channelizer and the per channel RX front end, in channels per core
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Channelizer.h"
+#include "Decimator.h"
+#include "FMDemod.h"
+#include "Resampler.h"
+
+#include <cstdio>
+#include <ctime>
+
+// The top of the SX_SAMPLE_RATE range the README gives, two seconds of it per run
+const uint32_t SDR_RATE      = 1000000U;
+const uint32_t BENCH_SECONDS = 2U;
+
+// Cycled through as the wideband input
+const uint32_t NOISE_LENGTH = 65536U;
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1E-9;
+}
+
+// What CIO::processRx does to a channel after the channelizer, returns the modem samples made
+static uint32_t frontEnd(const std::complex<float>* in, uint32_t length, uint32_t channelRate)
+{
+  static q15_t iq[2U * SDR_BLOCK_SIZE];
+  static q15_t i15[SDR_BLOCK_SIZE], q15[SDR_BLOCK_SIZE], demod[SDR_BLOCK_SIZE], modem[SDR_BLOCK_SIZE];
+
+  CDecimator decimator;
+  uint32_t demodRate = decimator.setRates(channelRate, 2U * MODEM_SAMPLE_RATE);
+
+  CFMDemod fmDemod;
+  fmDemod.setSampleRate(double(demodRate));
+
+  CResampler resampler;
+  if (!resampler.setRates(demodRate, MODEM_SAMPLE_RATE))
+    return 0U;
+
+  uint16_t block = resampler.getMaxInput(SDR_BLOCK_SIZE) * decimator.getDecimation();
+  if (block > SDR_BLOCK_SIZE)
+    block = SDR_BLOCK_SIZE - SDR_BLOCK_SIZE % decimator.getDecimation();
+
+  uint32_t samples = 0U;
+  for (uint32_t pos = 0U; pos < length; pos += block) {
+    uint16_t len = length - pos < block ? uint16_t(length - pos) : block;
+
+    const float* f = reinterpret_cast<const float*>(in + pos);
+    for (uint16_t i = 0U; i < 2U * len; i++) {
+      float v = f[i] * 32768.0F;
+      v = v >  32767.0F ?  32767.0F : v;
+      v = v < -32768.0F ? -32768.0F : v;
+      iq[i] = q15_t(v);
+    }
+
+    uint16_t n = decimator.process(iq, len, i15, q15);
+    if (n == 0U)
+      continue;
+
+    fmDemod.process(i15, q15, demod, n);
+    samples += resampler.process(demod, n, modem);
+  }
+
+  return samples;
+}
+
+int main()
+{
+  static std::complex<float> noise[NOISE_LENGTH];
+  uint32_t seed = 1U;
+  for (uint32_t i = 0U; i < NOISE_LENGTH; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    float re = float(int32_t(seed >> 16) - 32768) / 65536.0F;
+    seed = seed * 1664525U + 1013904223U;
+    float im = float(int32_t(seed >> 16) - 32768) / 65536.0F;
+    noise[i] = std::complex<float>(re, im);
+  }
+
+  const uint32_t total = SDR_RATE * BENCH_SECONDS;
+
+  // One channel kept whole for the front end run, the others only for the channelizer to write
+  static std::complex<float> channel0[SDR_RATE * BENCH_SECONDS];
+  static std::complex<float> outputs[CHANNELIZER_MAX_CHANNELS][SDR_BLOCK_SIZE];
+
+  ::printf("%u samples/s in, per cent of a core for %u s of input\n", SDR_RATE, BENCH_SECONDS);
+  ::printf("%8s  %10s  %11s  %11s  %17s\n", "channels", "spacing Hz", "channelizer", "per channel", "channels per core");
+
+  uint32_t samples = 0U;
+  for (uint16_t channels = 2U; channels <= CHANNELIZER_MAX_CHANNELS; channels *= 2U) {
+    static CChannelizer channelizer;
+    channelizer.setChannels(channels);
+    channelizer.reset();
+
+    const uint32_t channelRate = SDR_RATE / channelizer.getDecimation();
+
+    std::complex<float>* out[CHANNELIZER_MAX_CHANNELS] = {NULL};
+    for (uint16_t k = 0U; k < channels; k++)
+      out[k] = outputs[k];
+
+    uint32_t length = 0U;
+
+    double start = now();
+    for (uint32_t pos = 0U; pos < total; pos += SDR_BLOCK_SIZE) {
+      uint16_t n = channelizer.process(noise + pos % NOISE_LENGTH, SDR_BLOCK_SIZE, out);
+      for (uint16_t i = 0U; i < n; i++)
+        channel0[length++] = outputs[0U][i];
+    }
+    double channelizerLoad = (now() - start) / double(BENCH_SECONDS);
+
+    ::printf("%8u  %10u  %10.2f%%", channels, SDR_RATE / channels, channelizerLoad * 100.0);
+
+    // The discriminator needs twice the modem rate to work from
+    if (channelRate < 2U * MODEM_SAMPLE_RATE) {
+      ::printf("  %11s  %17s\n", "-", "too narrow");
+      continue;
+    }
+
+    start = now();
+    samples += frontEnd(channel0, length, channelRate);
+    double channelLoad = (now() - start) / double(BENCH_SECONDS);
+
+    // Front ends that fit beside the channelizer, it can be more than the channels there are
+    uint32_t perCore = channelizerLoad < 1.0 ? uint32_t((1.0 - channelizerLoad) / channelLoad) : 0U;
+
+    ::printf("  %10.2f%%  %17u\n", channelLoad * 100.0, perCore);
+  }
+
+  ::printf("%u modem samples\n", samples);
+  ::printf("The decoders of each channel come on top, see rxchain_bench for them per mode\n");
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ *   Test of the CEvent wakeups, with a PTY as the serial port
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Event.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+// As CIO::wait uses it
+const int WAIT_TIMEOUT_MS = 20;
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) * 1E3 + double(ts.tv_nsec) * 1E-6;
+}
+
+static bool check(const char* name, bool ok)
+{
+  ::printf("%-52s %s\n", name, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main()
+{
+  CEvent event;
+  if (!event.open())
+    return 1;
+
+  // The master side is what CSerialPort polls, the slave is where MMDVMHost connects
+  int master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (master == -1 || ::grantpt(master) != 0 || ::unlockpt(master) != 0) {
+    ::printf("Cannot open a PTY\n");
+    return 1;
+  }
+
+  int slave = ::open(::ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave == -1) {
+    ::printf("Cannot open the PTY slave\n");
+    return 1;
+  }
+
+  bool ok = true;
+
+  double start = now();
+  bool signalled = event.wait(WAIT_TIMEOUT_MS, master);
+  double ms = now() - start;
+  ok = check("idle PTY waits for the timeout", !signalled && ms >= WAIT_TIMEOUT_MS - 1) && ok;
+
+  event.signal();
+  start = now();
+  signalled = event.wait(1000, master);
+  ms = now() - start;
+  ok = check("a signal releases the wait at once", signalled && ms < WAIT_TIMEOUT_MS) && ok;
+
+  ssize_t n = ::write(slave, "x", 1U);
+  start = now();
+  signalled = event.wait(1000, master);
+  ms = now() - start;
+  ok = check("data from the host releases the wait at once", n == 1 && !signalled && ms < WAIT_TIMEOUT_MS) && ok;
+
+  char c;
+  n = ::read(master, &c, 1U);
+
+  // With the host gone poll reports POLLHUP straight away, the wait must not return early
+  ::close(slave);
+
+  start = now();
+  unsigned int waits = 0U;
+  while (now() - start < 10.0 * WAIT_TIMEOUT_MS) {
+    event.wait(WAIT_TIMEOUT_MS, master);
+    waits++;
+  }
+  ::printf("%u waits of %d ms in %.0f ms with the PTY slave closed\n", waits, WAIT_TIMEOUT_MS, now() - start);
+  ok = check("closed PTY slave waits for the timeout", waits <= 11U) && ok;
+
+  event.signal();
+  start = now();
+  signalled = event.wait(1000, master);
+  ms = now() - start;
+  ok = check("a signal still releases the wait at once", signalled && ms < WAIT_TIMEOUT_MS) && ok;
+
+  ::close(master);
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*
+ *   Test of the fused RX filter against the separate filters it replaces
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "RXFilters.h"
+
+#include <cstdio>
+#include <cstring>
+
+const uint32_t TEST_SAMPLES = 20U * MODEM_SAMPLE_RATE;
+
+// The cascade truncates the RRC output to q15 before the ISinc filter, so it can't be matched bit
+// for bit. That loses up to an LSB, which the ISinc raises to about three at its peak gain, and
+// rounding the combined taps to q15 adds about one more.
+const int32_t NXDN_CASCADE_MAX_ERROR = 4;
+
+struct FILTER {
+  const char*     name;
+  RX_FILTER_INPUT input;
+  const q15_t*    coeffs;
+  uint16_t        taps;
+};
+
+// As CIO sets them up
+const FILTER FILTERS[RX_FILTER_COUNT] = {
+  {"Gaussian",     RX_INPUT_DC,  GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN},
+  {"Gaussian raw", RX_INPUT_RAW, GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN},
+  {"boxcar",       RX_INPUT_DC,  BOXCAR_FILTER,                BOXCAR_FILTER_LEN},
+  {"NXDN",         RX_INPUT_DC,  NXDN_0_2_ISINC_FILTER.data(), NXDN_0_2_ISINC_FILTER_LEN},
+  {"RRC",          RX_INPUT_RAW, RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN},
+  {"RRC DC",       RX_INPUT_DC,  RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN}
+};
+
+static uint32_t seed = 1U;
+
+static uint32_t rand32()
+{
+  seed = seed * 1664525U + 1013904223U;
+  return seed;
+}
+
+// 2400 baud four level symbols at ten samples each with a little noise, the outer symbols at
+// three times level. The DC input is the raw one moved by a slowly changing offset, as the DC
+// blocker leaves it. A level of zero gives full scale symbols with no noise instead.
+static void makeSignal(q15_t* raw, q15_t* dc, uint32_t length, int32_t level)
+{
+  q15_t symbol = 0;
+  for (uint32_t i = 0U; i < length; i++) {
+    uint32_t r = rand32();
+    if ((i % 10U) == 0U)
+      symbol = level == 0 ? ((r >> 31) != 0U ? q15_t(32767) : q15_t(-32768)) : q15_t((int32_t(r >> 30) * 2 - 3) * level);
+
+    int32_t value = symbol + (level == 0 ? 0 : int32_t((r >> 8) & 0x1FFU) - 256);
+    raw[i] = q15_t(__SSAT(value, 16));
+
+    int32_t offset = int32_t((i / 4800U) % 5U) * 100 - 200;
+    int32_t shifted = raw[i] - offset;
+    dc[i] = q15_t(__SSAT(shifted, 16));
+  }
+}
+
+// Each output of the fused filter has to be exactly what its own arm_fir_fast_q15 gives, in blocks
+// of every size and with filters skipped now and then
+static bool testFused(bool saturate)
+{
+  static q15_t raw[TEST_SAMPLES], dc[TEST_SAMPLES];
+  makeSignal(raw, dc, TEST_SAMPLES, saturate ? 0 : 3000);
+
+  CFusedFIR fused;
+  for (uint8_t f = 0U; f < RX_FILTER_COUNT; f++)
+    fused.setFilter(f, FILTERS[f].input, FILTERS[f].coeffs, FILTERS[f].taps);
+  fused.reset();
+
+  static q15_t states[RX_FILTER_COUNT][FUSED_FIR_MAX_TAPS + RX_BLOCK_SIZE];
+  ::memset(states, 0x00, sizeof(states));
+
+  arm_fir_instance_q15 separate[RX_FILTER_COUNT];
+  for (uint8_t f = 0U; f < RX_FILTER_COUNT; f++) {
+    separate[f].numTaps = FILTERS[f].taps;
+    separate[f].pState  = states[f];
+    separate[f].pCoeffs = FILTERS[f].coeffs;
+  }
+
+  uint32_t mismatches[RX_FILTER_COUNT] = {0U};
+
+  uint32_t pos = 0U;
+  uint32_t block = 0U;
+  while (pos < TEST_SAMPLES) {
+    uint16_t length = uint16_t(rand32() % RX_BLOCK_SIZE) + 1U;
+    if (length > TEST_SAMPLES - pos)
+      length = uint16_t(TEST_SAMPLES - pos);
+
+    q15_t fusedOut[RX_FILTER_COUNT][RX_BLOCK_SIZE];
+    q15_t* out[RX_FILTER_COUNT];
+    for (uint8_t f = 0U; f < RX_FILTER_COUNT; f++)
+      out[f] = ((block + f) % 7U) == 0U ? NULL : fusedOut[f];
+
+    const q15_t* inputs[RX_FILTER_INPUTS] = {raw + pos, dc + pos};
+    fused.process(inputs, length, out);
+
+    // The separate filters always run, they only see what is passed to them
+    for (uint8_t f = 0U; f < RX_FILTER_COUNT; f++) {
+      q15_t in[RX_BLOCK_SIZE], expected[RX_BLOCK_SIZE];
+      ::memcpy(in, inputs[FILTERS[f].input], length * sizeof(q15_t));
+      ::arm_fir_fast_q15(&separate[f], in, expected, length);
+
+      if (out[f] != NULL && ::memcmp(expected, out[f], length * sizeof(q15_t)) != 0)
+        mismatches[f]++;
+    }
+
+    pos += length;
+    block++;
+  }
+
+  bool ok = true;
+  for (uint8_t f = 0U; f < RX_FILTER_COUNT; f++) {
+    ::printf("fused %-12s %s input: %s\n", FILTERS[f].name, saturate ? "saturating" : "4FSK", mismatches[f] == 0U ? "identical" : "DIFFERS");
+    ok = ok && mismatches[f] == 0U;
+  }
+
+  return ok;
+}
+
+// The combined NXDN filter against the RRC and ISinc run one after the other, as they were. The
+// RRC has a gain of about three, the symbols are kept low enough for its output not to clip.
+static bool testNXDNCascade()
+{
+  static q15_t raw[TEST_SAMPLES], dc[TEST_SAMPLES];
+  makeSignal(raw, dc, TEST_SAMPLES, 1000);
+
+  CFusedFIR fused;
+  fused.setFilter(0U, RX_INPUT_DC, NXDN_0_2_ISINC_FILTER.data(), NXDN_0_2_ISINC_FILTER_LEN);
+  fused.reset();
+
+  static q15_t rrcState[NXDN_0_2_FILTER_LEN + RX_BLOCK_SIZE];
+  static q15_t isincState[NXDN_ISINC_FILTER_LEN + RX_BLOCK_SIZE];
+  ::memset(rrcState, 0x00, sizeof(rrcState));
+  ::memset(isincState, 0x00, sizeof(isincState));
+
+  arm_fir_instance_q15 rrc   = {NXDN_0_2_FILTER_LEN,   rrcState,   NXDN_0_2_FILTER.data()};
+  arm_fir_instance_q15 isinc = {NXDN_ISINC_FILTER_LEN, isincState, NXDN_ISINC_FILTER.data()};
+
+  int32_t  maxError = 0;
+  uint64_t sumError = 0U;
+
+  for (uint32_t pos = 0U; pos < TEST_SAMPLES; pos += RX_BLOCK_SIZE) {
+    uint16_t length = RX_BLOCK_SIZE;
+    if (length > TEST_SAMPLES - pos)
+      length = uint16_t(TEST_SAMPLES - pos);
+
+    q15_t combined[RX_BLOCK_SIZE];
+    q15_t* out[FUSED_FIR_MAX_FILTERS] = {combined};
+    const q15_t* inputs[RX_FILTER_INPUTS] = {raw + pos, dc + pos};
+    fused.process(inputs, length, out);
+
+    q15_t in[RX_BLOCK_SIZE], filtered[RX_BLOCK_SIZE], cascade[RX_BLOCK_SIZE];
+    ::memcpy(in, dc + pos, length * sizeof(q15_t));
+    ::arm_fir_fast_q15(&rrc, in, filtered, length);
+    ::arm_fir_fast_q15(&isinc, filtered, cascade, length);
+
+    for (uint16_t i = 0U; i < length; i++) {
+      int32_t error = int32_t(combined[i]) - int32_t(cascade[i]);
+      if (error < 0)
+        error = -error;
+
+      if (error > maxError)
+        maxError = error;
+      sumError += uint32_t(error);
+    }
+  }
+
+  ::printf("NXDN combined against the cascade: max error %d LSB, mean %.3f LSB\n", maxError, double(sumError) / double(TEST_SAMPLES));
+
+  return maxError <= NXDN_CASCADE_MAX_ERROR;
+}
+
+int main()
+{
+  ::printf("DSP kernels: %s\n", ::arm_math_backend());
+
+  bool ok = testFused(false);
+  ok = testFused(true) && ok;
+  ok = testNXDNCascade() && ok;
+
+  return ok ? 0 : 1;
+}
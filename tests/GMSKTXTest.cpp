@@ -0,0 +1,132 @@
+/*
+ *   Test and benchmark of the D-Star GMSK table modulator against the interpolating filter
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "TXFilters.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+const uint32_t TEST_BYTES = 20000U;
+
+// Passes over the bytes for the timings
+const uint32_t BENCH_PASSES = 50U;
+
+const uint16_t SPS = DSTAR_RADIO_BIT_LENGTH;
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1E-9;
+}
+
+// The filter path CDStarTX::writeByte had, one arm_fir_interpolate_q15 per byte from a zeroed state
+class CFilterTX {
+public:
+  CFilterTX() :
+  m_filter(),
+  m_state()
+  {
+    m_filter.L           = SPS;
+    m_filter.phaseLength = GAUSSIAN_0_35_FILTER_PHASE_LEN;
+    m_filter.pCoeffs     = GAUSSIAN_0_35_FILTER.data();
+    m_filter.pState      = m_state;
+  }
+
+  void modulate(const uint8_t* data, uint32_t length, q15_t* out)
+  {
+    for (uint32_t i = 0U; i < length; i++) {
+      q15_t in[8U];
+
+      uint8_t c = data[i];
+      for (uint8_t j = 0U; j < 8U; j++, c >>= 1)
+        in[j] = (c & 0x01U) != 0U ? DSTAR_LEVEL0 : DSTAR_LEVEL1;
+
+      ::arm_fir_interpolate_q15(&m_filter, in, out, 8U);
+      out += 8U * SPS;
+    }
+  }
+
+private:
+  arm_fir_interpolate_instance_q15 m_filter;
+  q15_t                            m_state[GAUSSIAN_0_35_FILTER_PHASE_LEN + 8U - 1U];
+};
+
+int main()
+{
+  static uint8_t data[TEST_BYTES];
+  static q15_t   expected[TEST_BYTES * 8U * SPS];
+  static q15_t   table[TEST_BYTES * 8U * SPS];
+
+  uint32_t seed = 1U;
+  for (uint32_t i = 0U; i < TEST_BYTES; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    data[i] = uint8_t(seed >> 24);
+  }
+
+  ::printf("DSP kernels: %s\n", ::arm_math_backend());
+
+  CFilterTX filter;
+  filter.modulate(data, TEST_BYTES, expected);
+
+  // From power on, in runs of odd lengths as CDStarTX::process hands them over
+  CGMSKTX<SPS> modulator(DSTAR_MOD_TABLE.data());
+  uint32_t pos = 0U;
+  while (pos < TEST_BYTES) {
+    uint32_t n = 1U + (pos % 23U);
+    if (n > TEST_BYTES - pos)
+      n = TEST_BYTES - pos;
+
+    modulator.modulate(data + pos, uint16_t(n), table + pos * 8U * SPS);
+    pos += n;
+  }
+
+  uint32_t first = TEST_BYTES * 8U * SPS;
+  for (uint32_t i = 0U; i < TEST_BYTES * 8U * SPS && first == TEST_BYTES * 8U * SPS; i++) {
+    if (table[i] != expected[i])
+      first = i;
+  }
+
+  bool ok = first == TEST_BYTES * 8U * SPS;
+  if (ok)
+    ::printf("table against filter, %u random bytes from silence: identical\n", TEST_BYTES);
+  else
+    ::printf("table against filter, %u random bytes from silence: DIFFERS from sample %u, %d against %d\n", TEST_BYTES, first, table[first], expected[first]);
+
+  double start = now();
+  for (uint32_t p = 0U; p < BENCH_PASSES; p++) {
+    CFilterTX bench;
+    bench.modulate(data, TEST_BYTES, expected);
+  }
+  double filterNs = (now() - start) * 1E9 / double(BENCH_PASSES * TEST_BYTES);
+
+  start = now();
+  for (uint32_t p = 0U; p < BENCH_PASSES; p++) {
+    CGMSKTX<SPS> bench(DSTAR_MOD_TABLE.data());
+    bench.modulate(data, TEST_BYTES, table);
+  }
+  double tableNs = (now() - start) * 1E9 / double(BENCH_PASSES * TEST_BYTES);
+
+  ::printf("ns per byte: filter %.1f, table %.1f\n", filterNs, tableNs);
+
+  // The timed runs start from silence too, so they must agree as well
+  return ok && ::memcmp(expected, table, sizeof(table)) == 0 ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+/*
+ *   Benchmark of the RX DSP chain of CIO::process per mode and block size
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "RXFilters.h"
+#include "SymbolDecimator.h"
+#include "SymbolTiming.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+// One minute of modem samples per run
+const uint32_t BENCH_SAMPLES = 60U * MODEM_SAMPLE_RATE;
+
+// The old RX_BLOCK_SIZE, a middle size and the current one
+const uint16_t BLOCK_SIZES[] = {2U, 64U, RX_BLOCK_SIZE};
+const unsigned int BLOCK_SIZE_COUNT = sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0U]);
+
+struct BENCH_MODE {
+  const char* name;
+  bool        gaussian;
+  bool        boxcar;
+  bool        nxdn;
+  bool        rrc;
+  bool        rrcDC;
+};
+
+// The filter outputs CIO::process picks in each state, with every mode enabled
+const BENCH_MODE MODES[] = {
+  {"idle",   true,  true,  true,  true,  false},
+  {"D-Star", true,  false, false, false, false},
+  {"DMR",    false, false, false, true,  false},
+  {"YSF",    false, false, false, false, true},
+  {"P25",    false, true,  false, false, false},
+  {"NXDN",   false, false, true,  false, false}
+};
+const unsigned int MODE_COUNT = sizeof(MODES) / sizeof(MODES[0U]);
+
+// Everything CIO keeps for the RX chain
+class CRXChain {
+public:
+  CRXChain() :
+  m_dcFilter(),
+  m_dcState(),
+  m_rxFilters(),
+  m_rrcDecimator(),
+  m_p25Decimator(),
+  m_nxdnDecimator(),
+  m_rrcTiming(),
+  m_p25Timing(),
+  m_nxdnTiming()
+  {
+    m_dcFilter.numStages = DC_FILTER_STAGES;
+    m_dcFilter.pState    = m_dcState;
+    m_dcFilter.pCoeffs   = DC_FILTER;
+    m_dcFilter.postShift = 0;
+
+    m_rxFilters.setFilter(RX_FILTER_GAUSSIAN,     RX_INPUT_DC,  GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN);
+    m_rxFilters.setFilter(RX_FILTER_GAUSSIAN_RAW, RX_INPUT_RAW, GAUSSIAN_0_5_FILTER.data(),   GAUSSIAN_0_5_FILTER_LEN);
+    m_rxFilters.setFilter(RX_FILTER_BOXCAR,       RX_INPUT_DC,  BOXCAR_FILTER,                BOXCAR_FILTER_LEN);
+    m_rxFilters.setFilter(RX_FILTER_NXDN,         RX_INPUT_DC,  NXDN_0_2_ISINC_FILTER.data(), NXDN_0_2_ISINC_FILTER_LEN);
+    m_rxFilters.setFilter(RX_FILTER_RRC,          RX_INPUT_RAW, RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN);
+    m_rxFilters.setFilter(RX_FILTER_RRC_DC,       RX_INPUT_DC,  RRC_0_2_FILTER.data(),        RRC_0_2_FILTER_LEN);
+    m_rxFilters.reset();
+
+    m_rrcDecimator.setRatio(SPS_4800, DMR_RX_SYMBOL_LENGTH);
+    m_p25Decimator.setRatio(SPS_4800, P25_RX_SYMBOL_LENGTH);
+    m_nxdnDecimator.setRatio(SPS_2400, NXDN_RX_SYMBOL_LENGTH);
+
+    m_rrcTiming.setSymbolLength(DMR_RX_SYMBOL_LENGTH);
+    m_p25Timing.setSymbolLength(P25_RX_SYMBOL_LENGTH);
+    m_nxdnTiming.setSymbolLength(NXDN_RX_SYMBOL_LENGTH);
+  }
+
+  // The body of the CIO::process block loop up to the decoders, returns the symbols made so
+  // the work can't be optimised away
+  uint32_t process(const BENCH_MODE& mode, const uint16_t* raw, const uint16_t* rssi, const uint8_t* control, uint16_t length)
+  {
+    q15_t samples[RX_BLOCK_SIZE];
+    for (uint16_t i = 0U; i < length; i++) {
+      q31_t res = q15_t(raw[i]) * (128 * 128);
+      samples[i] = q15_t(__SSAT((res >> 15), 16));
+    }
+
+    q31_t q31Samples[RX_BLOCK_SIZE];
+    ::arm_q15_to_q31(samples, q31Samples, length);
+
+    q31_t dcValues[RX_BLOCK_SIZE];
+    ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, length);
+
+    q63_t dcLevel = 0;
+    for (uint16_t i = 0U; i < length; i++)
+      dcLevel += dcValues[i];
+    dcLevel /= length;
+
+    q15_t offset = q15_t(__SSAT(q31_t(dcLevel >> 16), 16));
+
+    q15_t dcSamples[RX_BLOCK_SIZE];
+    for (uint16_t i = 0U; i < length; i++)
+      dcSamples[i] = samples[i] - offset;
+
+    q15_t GMSKVals[RX_BLOCK_SIZE];
+    q15_t P25Vals[RX_BLOCK_SIZE];
+    q15_t NXDNVals[RX_BLOCK_SIZE];
+    q15_t RRCVals[RX_BLOCK_SIZE];
+
+    q15_t* filtered[RX_FILTER_COUNT] = {NULL};
+    if (mode.gaussian)
+      filtered[RX_FILTER_GAUSSIAN] = GMSKVals;
+    if (mode.boxcar)
+      filtered[RX_FILTER_BOXCAR] = P25Vals;
+    if (mode.nxdn)
+      filtered[RX_FILTER_NXDN] = NXDNVals;
+    if (mode.rrc)
+      filtered[RX_FILTER_RRC] = RRCVals;
+    if (mode.rrcDC)
+      filtered[RX_FILTER_RRC_DC] = RRCVals;
+
+    const q15_t* inputs[RX_FILTER_INPUTS] = {samples, dcSamples};
+    m_rxFilters.process(inputs, length, filtered);
+
+    uint32_t symbols = 0U;
+
+    q15_t    syms[RX_BLOCK_SIZE];
+    uint16_t symsRSSI[RX_BLOCK_SIZE];
+    uint8_t  symsControl[RX_BLOCK_SIZE];
+    q15_t    centres[RX_BLOCK_SIZE];
+    uint16_t centresRSSI[RX_BLOCK_SIZE];
+
+    if (mode.rrc || mode.rrcDC) {
+      uint16_t n = m_rrcDecimator.process(RRCVals, rssi, control, length, syms, symsRSSI, symsControl);
+      if (n > 0U)
+        symbols += m_rrcTiming.process(syms, symsRSSI, n, centres, centresRSSI);
+    }
+
+    if (mode.boxcar) {
+      uint16_t n = m_p25Decimator.process(P25Vals, rssi, NULL, length, syms, symsRSSI, NULL);
+      if (n > 0U)
+        symbols += m_p25Timing.process(syms, symsRSSI, n, centres, centresRSSI);
+    }
+
+    if (mode.nxdn) {
+      uint16_t n = m_nxdnDecimator.process(NXDNVals, rssi, NULL, length, syms, symsRSSI, NULL);
+      if (n > 0U)
+        symbols += m_nxdnTiming.process(syms, symsRSSI, n, centres, centresRSSI);
+    }
+
+    if (mode.gaussian)
+      symbols += uint16_t(GMSKVals[length - 1U]) & 1U;
+
+    return symbols;
+  }
+
+private:
+  arm_biquad_casd_df1_inst_q31 m_dcFilter;
+  q31_t                        m_dcState[4];
+  CFusedFIR                    m_rxFilters;
+  CSymbolDecimator             m_rrcDecimator;
+  CSymbolDecimator             m_p25Decimator;
+  CSymbolDecimator             m_nxdnDecimator;
+  CSymbolTiming                m_rrcTiming;
+  CSymbolTiming                m_p25Timing;
+  CSymbolTiming                m_nxdnTiming;
+};
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1E-9;
+}
+
+// A 4800 baud four level signal with a little noise, as the discriminator delivers it
+static void makeSignal(uint16_t* raw, uint32_t length)
+{
+  uint32_t seed   = 1U;
+  q15_t    symbol = 0;
+  for (uint32_t i = 0U; i < length; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    if ((i % 5U) == 0U)
+      symbol = q15_t((int32_t(seed >> 30) * 2 - 3) * 2000);
+
+    raw[i] = uint16_t(q15_t(symbol + q15_t(int32_t((seed >> 8) & 0x3FFU) - 512)));
+  }
+}
+
+int main()
+{
+  static uint16_t raw[BENCH_SAMPLES];
+  static uint16_t rssi[RX_BLOCK_SIZE];
+  static uint8_t  control[RX_BLOCK_SIZE];
+
+  makeSignal(raw, BENCH_SAMPLES);
+
+  ::printf("DSP kernels: %s\n", ::arm_math_backend());
+  ::printf("%-8s", "mode");
+  for (unsigned int b = 0U; b < BLOCK_SIZE_COUNT; b++)
+    ::printf("  %12s %3u", "ns/sample at", BLOCK_SIZES[b]);
+  ::printf("  %% of a core at %u\n", BLOCK_SIZES[BLOCK_SIZE_COUNT - 1U]);
+
+  uint32_t symbols = 0U;
+  for (unsigned int m = 0U; m < MODE_COUNT; m++) {
+    ::printf("%-8s", MODES[m].name);
+
+    double ns = 0.0;
+    for (unsigned int b = 0U; b < BLOCK_SIZE_COUNT; b++) {
+      CRXChain chain;
+
+      double start = now();
+      for (uint32_t pos = 0U; pos < BENCH_SAMPLES; pos += BLOCK_SIZES[b]) {
+        uint16_t length = BLOCK_SIZES[b];
+        if (length > BENCH_SAMPLES - pos)
+          length = uint16_t(BENCH_SAMPLES - pos);
+
+        symbols += chain.process(MODES[m], raw + pos, rssi, control, length);
+      }
+
+      ns = (now() - start) * 1E9 / double(BENCH_SAMPLES);
+      ::printf("  %16.1f", ns);
+    }
+
+    ::printf("  %5.2f%%\n", ns * double(MODEM_SAMPLE_RATE) * 1E-7);
+  }
+
+  ::printf("%u symbols\n", symbols);
+
+  return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ *   Benchmark of the TX ring writes, per sample against chunked, and of their latency
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "SampleRB.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The sizes used by CIO
+const uint16_t RING_SIZE  = 512U;
+const uint16_t CHUNK_SIZE = 32U;
+const uint16_t READ_SIZE  = 512U;
+
+const uint32_t BENCH_SAMPLES  = 20000000U;
+const uint32_t THREAD_SAMPLES = 2000000U;
+
+// The latency run writes a chunk every period, about twenty times the modem rate, so the
+// reader mostly finds the ring near empty
+const uint32_t LATENCY_SAMPLES   = 1000000U;
+const uint64_t LATENCY_PERIOD_NS = 64000U;
+
+const int16_t TX_LEVEL = 16384;
+
+static uint16_t level(int16_t sample)
+{
+  int32_t res = (sample * TX_LEVEL) >> 15;
+  return uint16_t(res > 32767 ? 32767 : (res < -32768 ? -32768 : res));
+}
+
+// What a transmitter hands to CIO::write, a counter so the order can be checked
+static int16_t source(uint32_t n)
+{
+  return int16_t(n & 0x7FFFU);
+}
+
+enum WRITE_MODE {
+  WRITE_LOCKED,
+  WRITE_SAMPLE,
+  WRITE_CHUNK
+};
+
+static std::mutex lock;
+
+// The old CIO::write took the ring mutex for each sample, then the lock-free ring was written
+// a sample at a time, now the levelled samples go in chunks
+static uint16_t write(WRITE_MODE mode, CSampleRB& ring, uint32_t start, uint16_t length)
+{
+  uint16_t n = 0U;
+
+  if (mode == WRITE_CHUNK) {
+    uint16_t out[CHUNK_SIZE];
+    while (n < length) {
+      uint16_t len = length - n;
+      if (len > CHUNK_SIZE)
+        len = CHUNK_SIZE;
+
+      for (uint16_t i = 0U; i < len; i++)
+        out[i] = level(source(start + n + i));
+
+      uint16_t put = ring.put(out, NULL, 0U, len);
+      n += put;
+      if (put < len)
+        break;
+    }
+  } else {
+    for (; n < length; n++) {
+      if (mode == WRITE_LOCKED) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!ring.put(level(source(start + n)), 0U))
+          break;
+      } else {
+        if (!ring.put(level(source(start + n)), 0U))
+          break;
+      }
+    }
+  }
+
+  return n;
+}
+
+static double now()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1E-9;
+}
+
+// One thread fills the ring and empties it, only the filling is timed
+static double bench(WRITE_MODE mode)
+{
+  CSampleRB ring(RING_SIZE);
+  uint16_t  out[READ_SIZE];
+
+  double   time = 0.0;
+  uint32_t done = 0U;
+  while (done < BENCH_SAMPLES) {
+    double start = now();
+    done += write(mode, ring, done, ring.getSpace());
+    time += now() - start;
+
+    while (ring.get(out, NULL, NULL, READ_SIZE) > 0U)
+      ;
+  }
+
+  return time * 1E9 / double(done);
+}
+
+// The TX thread reads while the transmitters write, every sample has to arrive in order
+static bool check(WRITE_MODE mode)
+{
+  CSampleRB ring(RING_SIZE);
+  bool ok = true;
+
+  std::thread reader([&ring, &ok]() {
+    uint16_t out[READ_SIZE];
+    uint32_t n = 0U;
+    while (n < THREAD_SAMPLES) {
+      uint16_t len = ring.get(out, NULL, NULL, READ_SIZE);
+      for (uint16_t i = 0U; i < len; i++, n++) {
+        if (out[i] != level(source(n)))
+          ok = false;
+      }
+    }
+  });
+
+  // Odd sized writes, as the transmitters make them
+  uint32_t n = 0U;
+  uint16_t size = 1U;
+  while (n < THREAD_SAMPLES) {
+    uint16_t len = size;
+    if (len > THREAD_SAMPLES - n)
+      len = uint16_t(THREAD_SAMPLES - n);
+
+    n += write(mode, ring, n, len);
+
+    size = size % 479U + 7U;
+  }
+
+  reader.join();
+
+  return ok;
+}
+
+static uint64_t nowNs()
+{
+  struct timespec ts;
+  ::clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000U + uint64_t(ts.tv_nsec);
+}
+
+// The time from each sample's put starting to the get that returns it, with the writer paced and
+// the reader polling and yielding while the ring is empty. The old ring took the mutex on both
+// sides.
+static void latency(WRITE_MODE mode, double& p99, double& max)
+{
+  static uint64_t putTime[LATENCY_SAMPLES];
+  static uint64_t getTime[LATENCY_SAMPLES];
+
+  CSampleRB ring(RING_SIZE);
+
+  std::thread reader([mode, &ring]() {
+    uint16_t out[READ_SIZE];
+    uint32_t n = 0U;
+    while (n < LATENCY_SAMPLES) {
+      uint16_t len = 0U;
+      if (mode == WRITE_LOCKED) {
+        std::lock_guard<std::mutex> guard(lock);
+        len = ring.get(out, NULL, NULL, READ_SIZE);
+      } else {
+        len = ring.get(out, NULL, NULL, READ_SIZE);
+      }
+
+      if (len == 0U) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      uint64_t t = nowNs();
+      for (uint16_t i = 0U; i < len; i++)
+        getTime[n++] = t;
+    }
+  });
+
+  struct timespec next;
+  ::clock_gettime(CLOCK_MONOTONIC, &next);
+
+  uint32_t n = 0U;
+  while (n < LATENCY_SAMPLES) {
+    next.tv_nsec += long(LATENCY_PERIOD_NS);
+    if (next.tv_nsec >= 1000000000L) {
+      next.tv_nsec -= 1000000000L;
+      next.tv_sec++;
+    }
+    ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+    uint16_t len = CHUNK_SIZE;
+    if (len > LATENCY_SAMPLES - n)
+      len = uint16_t(LATENCY_SAMPLES - n);
+
+    uint64_t t = nowNs();
+    uint16_t put = write(mode, ring, n, len);
+    for (uint16_t i = 0U; i < put; i++)
+      putTime[n + i] = t;
+
+    n += put;
+  }
+
+  reader.join();
+
+  std::vector<uint64_t> latencies(LATENCY_SAMPLES);
+  for (uint32_t i = 0U; i < LATENCY_SAMPLES; i++)
+    latencies[i] = getTime[i] - putTime[i];
+
+  std::vector<uint64_t>::iterator p = latencies.begin() + (LATENCY_SAMPLES * 99U) / 100U;
+  std::nth_element(latencies.begin(), p, latencies.end());
+  p99 = double(*p) * 1E-3;
+  max = double(*std::max_element(latencies.begin(), latencies.end())) * 1E-3;
+}
+
+int main()
+{
+  const char* names[] = {"locked per sample", "per sample", "chunked"};
+
+  bool ok = true;
+  for (unsigned int i = 0U; i < 3U; i++) {
+    WRITE_MODE mode = WRITE_MODE(i);
+
+    bool pass = check(mode);
+    ok = ok && pass;
+
+    ::printf("%-18s %6.2f ns/sample  %s\n", names[i], bench(mode), pass ? "in order" : "OUT OF ORDER");
+  }
+
+  ::printf("put to get latency, %u samples in chunks of %u every %.0f us\n", LATENCY_SAMPLES, CHUNK_SIZE, double(LATENCY_PERIOD_NS) * 1E-3);
+  for (unsigned int i = 0U; i < 3U; i++) {
+    double p99 = 0.0, max = 0.0;
+    latency(WRITE_MODE(i), p99, max);
+
+    ::printf("%-18s p99 %8.2f us  max %8.2f us\n", names[i], p99, max);
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ *   Test of the 4FSK symbol timing recovery with a fractional offset and a clock rate error
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "SymbolDecimator.h"
+#include "SymbolTiming.h"
+
+#include <cmath>
+#include <cstdio>
+
+const uint32_t TEST_SYMBOLS = 4000U;
+
+// The loop has to be locked this many symbols in, from then on every decision must be right
+const uint32_t LOCK_SYMBOLS = 600U;
+
+// The symbols are +/-1 and +/-3 times this, about what the RX filters give
+const double SYMBOL_LEVEL = 1500.0;
+
+// Raised cosine pulses, the RRC of the transmitter and the receiver together
+const double PULSE_BETA = 0.2;
+const int    PULSE_SPAN = 8;
+
+static uint32_t seed = 1U;
+
+static uint32_t rand32()
+{
+  seed = seed * 1664525U + 1013904223U;
+  return seed;
+}
+
+static double raisedCosine(double t)
+{
+  if (::fabs(t) < 1E-9)
+    return 1.0;
+
+  double x = 2.0 * PULSE_BETA * t;
+  if (::fabs(::fabs(x) - 1.0) < 1E-9)
+    return M_PI / 4.0 * ::sin(M_PI * t) / (M_PI * t);
+
+  return ::sin(M_PI * t) / (M_PI * t) * ::cos(M_PI * PULSE_BETA * t) / (1.0 - x * x);
+}
+
+static int decide(double value)
+{
+  const double threshold = 2.0 * SYMBOL_LEVEL;
+  return value > threshold ? 3 : (value > 0 ? 1 : (value > -threshold ? -1 : -3));
+}
+
+// The symbols sent at sps samples per symbol, starting offset symbols late, with the
+// transmitter clock ppm fast and a DC offset, through the symbol decimator and the timing loop
+// as CIO runs them. Returns the symbol after which every decision matched, or TEST_SYMBOLS when
+// they never did.
+static uint32_t run(uint16_t sps, uint16_t symbolLength, double offset, double ppm, double dc)
+{
+  static int   symbols[TEST_SYMBOLS];
+  static q15_t samples[TEST_SYMBOLS * 10U];
+  static q15_t decimated[TEST_SYMBOLS * 10U];
+  static q15_t strobes[TEST_SYMBOLS + 10U];
+  static uint16_t rssi[TEST_SYMBOLS * 10U];
+  static uint16_t rssiDecimated[TEST_SYMBOLS * 10U];
+  static uint16_t rssiOut[TEST_SYMBOLS + 10U];
+
+  for (uint32_t k = 0U; k < TEST_SYMBOLS; k++)
+    symbols[k] = int(rand32() >> 30) * 2 - 3;
+
+  // In symbols of the transmitter clock
+  const double step = (1.0 + ppm * 1E-6) / double(sps);
+
+  const uint32_t length = TEST_SYMBOLS * sps - PULSE_SPAN * sps;
+  for (uint32_t n = 0U; n < length; n++) {
+    double t = double(n) * step - offset;
+
+    double sum = 0.0;
+    int centre = int(::floor(t));
+    for (int k = centre - PULSE_SPAN; k <= centre + PULSE_SPAN; k++) {
+      if (k >= 0 && k < int(TEST_SYMBOLS))
+        sum += double(symbols[k]) * raisedCosine(t - double(k));
+    }
+
+    // A little noise, well below the decision distance
+    double noise = double(int32_t(rand32() >> 23) - 256) * 0.5;
+    samples[n] = q15_t(::lround(sum * SYMBOL_LEVEL + dc + noise));
+    rssi[n] = 0U;
+  }
+
+  CSymbolDecimator decimator;
+  decimator.setRatio(sps, symbolLength);
+
+  CSymbolTiming timing;
+  timing.setSymbolLength(symbolLength);
+
+  uint32_t count = 0U;
+  for (uint32_t pos = 0U; pos < length; pos += RX_BLOCK_SIZE) {
+    uint16_t len = length - pos < RX_BLOCK_SIZE ? uint16_t(length - pos) : RX_BLOCK_SIZE;
+
+    uint16_t n = decimator.process(samples + pos, rssi + pos, NULL, len, decimated, rssiDecimated, NULL);
+    count += timing.process(decimated, rssiDecimated, n, strobes + count, rssiOut + count);
+  }
+
+  // The strobes start with the filter delay and the loop may settle a symbol either way, find the
+  // shift that best matches the end of the run
+  int best = 0;
+  uint32_t bestMatches = 0U;
+  for (int shift = -4; shift <= 4; shift++) {
+    uint32_t matches = 0U;
+    for (uint32_t i = count / 2U; i < count; i++) {
+      int k = int(i) + shift;
+      if (k >= 0 && k < int(TEST_SYMBOLS) && decide(strobes[i] - dc) == symbols[k])
+        matches++;
+    }
+
+    if (matches > bestMatches) {
+      bestMatches = matches;
+      best = shift;
+    }
+  }
+
+  // The last strobes may come from the interpolator running past the end of the signal
+  const uint32_t end = count - 2U;
+
+  uint32_t locked = 0U;
+  for (uint32_t i = 0U; i < end; i++) {
+    int k = int(i) + best;
+    if (k < 0 || k >= int(TEST_SYMBOLS) || decide(strobes[i] - dc) != symbols[k])
+      locked = i + 1U;
+  }
+
+  return locked >= end ? TEST_SYMBOLS : locked;
+}
+
+int main()
+{
+  const double offsets[] = {0.25, 0.5, 0.75};
+  const double ppms[]    = {-1000.0, 0.0, 1000.0};
+  const double dcs[]     = {0.0, 750.0};
+
+  bool ok = true;
+
+  // 4800 and 2400 baud, into each symbol length the RX decimators can be set to
+  for (uint16_t sps = 5U; sps <= 10U; sps += 5U) {
+    for (uint16_t symbolLength = 2U; symbolLength <= 5U; symbolLength++) {
+      uint32_t worst = 0U;
+      for (unsigned int o = 0U; o < 3U; o++) {
+        for (unsigned int p = 0U; p < 3U; p++) {
+          for (unsigned int d = 0U; d < 2U; d++) {
+            uint32_t locked = run(sps, symbolLength, offsets[o], ppms[p], dcs[d]);
+            if (locked > worst)
+              worst = locked;
+          }
+        }
+      }
+
+      bool pass = worst <= LOCK_SYMBOLS;
+      ::printf("%4u baud at %u samples per symbol: decisions right from symbol %4u %s\n", 24000U / sps, symbolLength, worst, pass ? "ok" : "FAILED");
+      ok = ok && pass;
+    }
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/*
+ *   Test of the sync correlator against a scalar correlation of the same window
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "SyncCorrelator.h"
+#include "DMRDefines.h"
+#include "YSFDefines.h"
+#include "P25Defines.h"
+#include "NXDNDefines.h"
+
+#include <cstdio>
+
+// Values written per sync and symbol length, the correlator is checked after every one
+const uint32_t TEST_VALUES = 20000U;
+
+struct SYNC {
+  const char*   name;
+  const int8_t* values;
+  uint8_t       length;
+};
+
+static const SYNC SYNCS[] = {
+  {"DMR MS data",  DMR_MS_DATA_SYNC_SYMBOLS_VALUES,  DMR_SYNC_LENGTH_SYMBOLS},
+  {"DMR MS voice", DMR_MS_VOICE_SYNC_SYMBOLS_VALUES, DMR_SYNC_LENGTH_SYMBOLS},
+  {"YSF",          YSF_SYNC_SYMBOLS_VALUES,          YSF_SYNC_LENGTH_SYMBOLS},
+  {"P25",          P25_SYNC_SYMBOLS_VALUES,          P25_SYNC_LENGTH_SYMBOLS},
+  {"NXDN",         NXDN_FSW_SYMBOLS_VALUES,          NXDN_FSW_LENGTH_SYMBOLS}
+};
+
+static uint32_t seed = 1U;
+
+static q15_t randQ15()
+{
+  seed = seed * 1664525U + 1013904223U;
+  return q15_t(seed >> 16);
+}
+
+// Writes random values, the full q15 range with runs at the limits, and compares each
+// correlation with the last length values of the newest value's phase worked out directly.
+// Before the history fills the missing values are zeros. The second pass checks that a reset
+// correlator starts from zeros again.
+static bool testSync(const SYNC& sync, uint16_t symbolLength)
+{
+  static q15_t written[TEST_VALUES];
+
+  CSyncCorrelator correlator;
+  correlator.setSync(sync.values, sync.length, symbolLength);
+
+  uint32_t errors = 0U;
+
+  for (unsigned int pass = 0U; pass < 2U; pass++) {
+    if (pass > 0U)
+      correlator.reset();
+
+    for (uint32_t n = 0U; n < TEST_VALUES; n++) {
+      q15_t val = randQ15();
+      if ((n / 500U) % 4U == 3U)
+        val = (val & 1) != 0 ? 32767 : -32768;
+
+      written[n] = val;
+      correlator.write(val);
+
+      q31_t corr = 0;
+      q15_t min  = 32767;
+      q15_t max  = -32768;
+      for (uint8_t i = 0U; i < sync.length; i++) {
+        int32_t index = int32_t(n) - int32_t(sync.length - 1U - i) * int32_t(symbolLength);
+        q15_t value = index < 0 ? 0 : written[index];
+
+        // A positive symbol is a negative sample out of the discriminator
+        corr += -q31_t(sync.values[i]) * value;
+
+        if (value < min)
+          min = value;
+        if (value > max)
+          max = value;
+      }
+
+      q15_t testMin, testMax;
+      q31_t testCorr = correlator.correlate(testMin, testMax);
+
+      if (testCorr != corr || testMin != min || testMax != max) {
+        if (errors == 0U)
+          ::printf("  %s at %u samples per symbol, pass %u value %u: corr %d min %d max %d, expected %d %d %d\n", sync.name, symbolLength, pass, n, testCorr, testMin, testMax, corr, min, max);
+        errors++;
+      }
+    }
+  }
+
+  return errors == 0U;
+}
+
+int main()
+{
+  bool ok = true;
+
+  ::printf("arm_math backend: %s\n", arm_math_backend());
+
+  for (unsigned int s = 0U; s < sizeof(SYNCS) / sizeof(SYNCS[0U]); s++) {
+    bool identical = true;
+
+    // A symbol stream from CSymbolTiming, and the samples per symbol of the DMR slot receivers
+    for (uint16_t symbolLength = 1U; symbolLength <= SYNC_CORRELATOR_MAX_SYMBOL_LENGTH; symbolLength++)
+      identical = testSync(SYNCS[s], symbolLength) && identical;
+
+    ::printf("%-12s %2u symbols: %s\n", SYNCS[s].name, SYNCS[s].length, identical ? "identical" : "DIFFERS");
+    ok = ok && identical;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*
+ *   Test of the synthesis bank against interpolating and mixing one channel directly
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "Synthesizer.h"
+
+#include <cmath>
+#include <cstdio>
+
+// Input samples per channel, taken in blocks as CIO::processTx does
+const uint16_t TEST_LENGTH = 2000U;
+const uint16_t TEST_BLOCK  = 37U;
+
+// Float against double over at most 1536 taps, relative to the signal of about 0.3
+const double MAX_ERROR = 1E-5;
+
+static uint32_t seed = 1U;
+
+static float randFloat()
+{
+  seed = seed * 1664525U + 1013904223U;
+  return float(int32_t(seed >> 16) - 32768) / 65536.0F;
+}
+
+// The direct path for channel k: zero stuff by N / 2, filter with the prototype at a gain of N / 2
+// and mix up to k * fs / N with an NCO
+static double testChannel(uint16_t channels, uint16_t k)
+{
+  static std::complex<float> in[TEST_LENGTH];
+  static std::complex<float> out[TEST_LENGTH * CHANNELIZER_MAX_CHANNELS / 2U];
+  static float prototype[CHANNELIZER_MAX_CHANNELS * CHANNELIZER_TAPS_PER_PATH];
+
+  for (uint16_t i = 0U; i < TEST_LENGTH; i++)
+    in[i] = std::complex<float>(randFloat(), randFloat());
+
+  static CSynthesizer synthesizer;
+  synthesizer.setChannels(channels);
+
+  const std::complex<float>* inputs[CHANNELIZER_MAX_CHANNELS] = {NULL};
+
+  uint32_t length = 0U;
+  for (uint16_t pos = 0U; pos < TEST_LENGTH; pos += TEST_BLOCK) {
+    uint16_t len = TEST_LENGTH - pos < TEST_BLOCK ? TEST_LENGTH - pos : TEST_BLOCK;
+    inputs[k] = in + pos;
+    length += synthesizer.process(inputs, len, out + length);
+  }
+
+  const uint16_t interpolation = channels / 2U;
+  const uint16_t taps = CChannelizer::designPrototype(channels, prototype);
+
+  double maxError = 0.0;
+  for (uint32_t m = 0U; m < length; m++) {
+    std::complex<double> sum(0.0, 0.0);
+    for (uint32_t i = 0U; i <= m / interpolation; i++) {
+      uint32_t l = m - i * interpolation;
+      if (l < taps)
+        sum += double(prototype[l]) * double(interpolation) * std::complex<double>(in[i]);
+    }
+
+    double phase = 2.0 * M_PI * double((uint32_t(k) * m) % channels) / double(channels);
+    std::complex<double> expected = sum * std::complex<double>(::cos(phase), ::sin(phase));
+
+    double error = std::abs(std::complex<double>(out[m]) - expected);
+    if (error > maxError)
+      maxError = error;
+  }
+
+  return maxError;
+}
+
+int main()
+{
+  bool ok = true;
+
+  for (uint16_t channels = 2U; channels <= CHANNELIZER_MAX_CHANNELS; channels *= 2U) {
+    // The centre channel, the first either side and the one at fs / 2
+    const uint16_t tested[] = {0U, 1U, uint16_t(channels - 1U), uint16_t(channels / 2U)};
+
+    double maxError = 0.0;
+    for (uint16_t t = 0U; t < 4U; t++) {
+      double error = testChannel(channels, tested[t]);
+      if (error > maxError)
+        maxError = error;
+    }
+
+    ::printf("%2u channels: max error %.2e against the direct path %s\n", channels, maxError, maxError <= MAX_ERROR ? "ok" : "FAILED");
+    ok = ok && maxError <= MAX_ERROR;
+  }
+
+  return ok ? 0 : 1;
+}
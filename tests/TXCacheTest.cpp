@@ -0,0 +1,170 @@
+/*
+ *   Test of the TX burst cache against the modulators writing through the IO
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Globals.h"
+#include "TXCache.h"
+#include "TXFilters.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Bytes of other traffic modulated before the bursts, so they don't start from the power on history
+const uint16_t LEAD_BYTES = 5U;
+
+/*
+ * The parts of CIO the cache uses, recording what would go to the TX ring. The io object itself
+ * is storage from TXCacheTestIO.cpp, these never touch its members, so the SDR side of CIO
+ * needn't be linked.
+ */
+static uint16_t written[TX_CACHE_BURST_SAMPLES];
+static uint16_t writtenLength = 0U;
+static bool     inWrite       = false;
+static uint32_t fills         = 0U;
+static q15_t    txLevel       = 128 * 128;
+static uint32_t levelSerial   = 1U;
+
+void CIO::write(MMDVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* control)
+{
+  uint16_t out[TX_CACHE_BURST_SAMPLES];
+
+  inWrite = true;
+  scale(mode, samples, out, length);
+  inWrite = false;
+
+  writeScaled(out, length, control);
+}
+
+void CIO::writeScaled(const uint16_t* samples, uint16_t length, const uint8_t*)
+{
+  ::memcpy(written + writtenLength, samples, length * sizeof(uint16_t));
+  writtenLength += length;
+}
+
+void CIO::scale(MMDVM_STATE, const q15_t* samples, uint16_t* out, uint16_t length) const
+{
+  // Outside write() only the cache scales samples, when it is filled
+  if (!inWrite)
+    fills++;
+
+  for (uint16_t i = 0U; i < length; i++) {
+    q31_t res1 = samples[i] * txLevel;
+    out[i] = uint16_t(q15_t(__SSAT((res1 >> 15), 16)));
+  }
+}
+
+uint32_t CIO::getLevelSerial() const
+{
+  return levelSerial;
+}
+
+// Sends the burst through the cache, chunk bytes at a time as the transmitters split it by the
+// space in the ring, then the same bytes modulated and written uncached. Both must give the same
+// samples, and the cache must be filled only when expected.
+template <class MOD>
+static bool sendBurst(const char* name, const char* step, CTXCache& cache, MOD& cached, MOD& uncached, MMDVM_STATE mode, const uint8_t* burst, uint16_t length, uint16_t chunk, bool fill)
+{
+  static uint16_t fromCache[TX_CACHE_BURST_SAMPLES];
+  q15_t samples[TX_CACHE_BURST_SAMPLES];
+
+  uint32_t filled = fills;
+
+  writtenLength = 0U;
+  for (uint16_t offset = 0U; offset < length; offset += chunk)
+    cache.writeBurst(cached, burst, length, offset, length - offset < chunk ? length - offset : chunk);
+
+  bool refilled = fills != filled;
+
+  uint16_t cachedLength = writtenLength;
+  ::memcpy(fromCache, written, cachedLength * sizeof(uint16_t));
+
+  writtenLength = 0U;
+  uncached.modulate(burst, length, samples);
+  io.write(mode, samples, length * MOD::BYTE_SAMPLES);
+
+  bool identical = cachedLength == writtenLength && ::memcmp(fromCache, written, cachedLength * sizeof(uint16_t)) == 0;
+
+  ::printf("%-6s %-28s %s, cache %s %s\n", name, step, identical ? "identical" : "DIFFERS", refilled ? "filled" : "not filled", refilled == fill ? "ok" : "FAILED");
+
+  return identical && refilled == fill;
+}
+
+template <class MOD>
+static bool testCache(const char* name, MMDVM_STATE mode, const MOD& modulator, const uint8_t* burst1, const uint8_t* burst2, uint16_t length)
+{
+  uint8_t lead[LEAD_BYTES];
+  for (uint16_t i = 0U; i < LEAD_BYTES; i++)
+    lead[i] = uint8_t(0x5AU + 37U * i);
+
+  q15_t samples[LEAD_BYTES * MOD::BYTE_SAMPLES];
+
+  MOD cached   = modulator;
+  MOD uncached = modulator;
+  cached.modulate(lead, LEAD_BYTES, samples);
+  uncached.modulate(lead, LEAD_BYTES, samples);
+
+  CTXCache cache(mode, length * MOD::BYTE_SAMPLES);
+
+  txLevel     = 128 * 128;
+  levelSerial = 1U;
+
+  bool ok = true;
+
+  ok = sendBurst(name, "first burst",                 cache, cached, uncached, mode, burst1, length, length, true)  && ok;
+  ok = sendBurst(name, "same burst",                  cache, cached, uncached, mode, burst1, length, length, false) && ok;
+
+  txLevel = 100 * 128;
+  levelSerial++;
+  ok = sendBurst(name, "same burst, level changed",   cache, cached, uncached, mode, burst1, length, length, true)  && ok;
+  ok = sendBurst(name, "same burst again",            cache, cached, uncached, mode, burst1, length, length, false) && ok;
+
+  ok = sendBurst(name, "different burst",             cache, cached, uncached, mode, burst2, length, length, true)  && ok;
+
+  levelSerial++;
+  ok = sendBurst(name, "same burst, serial changed",  cache, cached, uncached, mode, burst2, length, length, true)  && ok;
+
+  ok = sendBurst(name, "same burst, 3 bytes a write", cache, cached, uncached, mode, burst2, length, 3U, false)     && ok;
+
+  txLevel = 140 * 128;
+  levelSerial++;
+  ok = sendBurst(name, "first burst, 3 bytes a write", cache, cached, uncached, mode, burst1, length, 3U, true)     && ok;
+
+  return ok;
+}
+
+int main()
+{
+  uint8_t burst1[TX_CACHE_BURST_BYTES];
+  uint8_t burst2[TX_CACHE_BURST_BYTES];
+
+  uint32_t seed = 1U;
+  for (uint16_t i = 0U; i < TX_CACHE_BURST_BYTES; i++) {
+    seed = seed * 1664525U + 1013904223U;
+    burst1[i] = uint8_t(seed >> 24);
+    seed = seed * 1664525U + 1013904223U;
+    burst2[i] = uint8_t(seed >> 24);
+  }
+
+  bool ok = true;
+
+  // The idle DMR frames and the D-Star end of transmission, the bursts kept in caches
+  ok = testCache("DMR",    STATE_DMR,   C4FSKTX<DMR_RADIO_SYMBOL_LENGTH>(DMR_MOD_TABLE.data()),    burst1, burst2, DMR_FRAME_LENGTH_BYTES)  && ok;
+  ok = testCache("D-Star", STATE_DSTAR, CGMSKTX<DSTAR_RADIO_BIT_LENGTH>(DSTAR_MOD_TABLE.data()),  burst1, burst2, 3U * DSTAR_EOT_LENGTH_BYTES) && ok;
+
+  return ok ? 0 : 1;
+}
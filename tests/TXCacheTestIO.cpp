@@ -0,0 +1,21 @@
+/*
+ *   Storage for the io object of the TX cache test
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// The CIO methods TXCacheTest.cpp replaces don't use the object, so it is never constructed and
+// the SDR, DSP and thread members of a real CIO aren't needed. This file must not see IO.h.
+alignas(64) unsigned char io[1U << 16];